@@ -0,0 +1,71 @@
+#ifndef __COEFFICIENTS_H__
+#define __COEFFICIENTS_H__
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Hashing {
+    // -- splitmix64 finalizer, every input bit affects every output bit
+    inline uint64_t mix(uint64_t h) noexcept
+    {
+        h ^= h >> 30;
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 27;
+        h *= 0x94D049BB133111EBull;
+        return h ^ (h >> 31);
+    }
+
+    // -- order-dependent, combine(a, b) != combine(b, a) in general
+    inline uint64_t combine(uint64_t seed, uint64_t value) noexcept
+    {
+        return mix(mix(seed) + value);
+    }
+}
+
+//
+// What monomials and polynomials need to know about their coefficient type
+// beyond the arithmetic operators, specialized along with the custom types
+//
+
+template<typename T>
+struct CoefficientTraits {
+    static_assert(std::is_arithmetic_v<T>, "Coefficient types other than the built-in ones need their own traits");
+
+    // -- rounded arithmetic, so floating point transforms are fine to multiply with
+    static constexpr bool APPROXIMATE = std::is_floating_point_v<T>;
+
+    static bool is_zero(const T& k) noexcept { return k == T(0); }
+    static bool is_negative(const T& k) noexcept { return k < T(0); }
+    static double to_double(const T& k) noexcept { return static_cast<double>(k); }
+
+    // -- equal values hash equally, so both zeros of the floating point types do
+    static uint64_t hash(const T& k) noexcept
+    {
+        if constexpr (std::is_floating_point_v<T>) {
+            if (k == T(0))
+                return 0;
+
+            const double d = static_cast<double>(k);
+            uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            return bits;
+        } else {
+            return static_cast<uint64_t>(k);
+        }
+    }
+
+    // -- parses the coefficient preceding the variables, false if there is none
+    template<class Reader>
+    static bool read(Reader& reader, T& k)
+    {
+        double d;
+        if (!reader.read_double(d))
+            return false;
+
+        k = static_cast<T>(d);
+        return true;
+    }
+};
+
+#endif // __COEFFICIENTS_H__
@@ -0,0 +1,291 @@
+#ifndef __COW_VECTOR_H__
+#define __COW_VECTOR_H__
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+//
+// Vector with copy-on-write storage: copies share the same reference-counted buffer,
+// which is only duplicated by the first modification through a copy that is not
+// the sole owner. The ownership check loads the count with acquire, pairing with
+// the release decrement of the copies dropped by other threads, so whatever they
+// have read from the buffer happens before it is written in place.
+// Element access is read-only on purpose: writes take the storage from mutate()
+// once, so the loops reading the elements never pay for the ownership check.
+// References into the storage are invalidated by copying the vector, since writing
+// through them would be seen by the copy as well
+//
+
+template<typename T>
+class CowVector
+{
+public:
+    typedef std::vector<T> storage_t;
+    typedef T value_type;
+    typedef typename storage_t::iterator iterator;
+    typedef typename storage_t::const_iterator const_iterator;
+private:
+    struct Buffer {
+        std::atomic<size_t> refs;
+        storage_t items;
+    };
+
+    // -- null while nothing was ever written, so that empty vectors do not allocate
+    Buffer* buffer = nullptr;
+
+    // -- drops the reference, the last owner frees the buffer
+    void release() noexcept;
+public:
+    CowVector() = default;
+    CowVector(const CowVector& other) noexcept;
+    CowVector(CowVector&& other) noexcept;
+    ~CowVector();
+
+    CowVector& operator=(const CowVector& other) noexcept;
+    CowVector& operator=(CowVector&& other) noexcept;
+
+    // -- the storage for reading, saves an indirection per element in the tight loops
+    [[nodiscard]] const storage_t& view() const noexcept;
+
+    // -- the storage owned by this vector alone, copied when it is shared
+    storage_t& mutate();
+    [[nodiscard]] bool is_shared() const noexcept;
+
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept;
+
+    const T& operator[](size_t idx) const noexcept;
+    const T& front() const noexcept;
+    const T& back() const noexcept;
+
+    const_iterator begin() const noexcept { return cbegin(); }
+    const_iterator end() const noexcept { return cend(); }
+    const_iterator cbegin() const noexcept;
+    const_iterator cend() const noexcept;
+
+    void reserve(size_t capacity);
+    void resize(size_t size, const T& value);
+    // -- drops a shared storage instead of copying it first
+    void clear() noexcept;
+
+    void push_back(const T& element);
+    void push_back(T&& element);
+    // -- positions come from the read-only iterators, they are translated on detaching
+    iterator insert(const_iterator pos, const T& element);
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+    template<typename InputIt>
+    void assign(InputIt first, InputIt last);
+
+    bool operator==(const CowVector& other) const;
+    bool operator!=(const CowVector& other) const;
+};
+
+template<typename T>
+CowVector<T>::CowVector(const CowVector& other) noexcept
+    : buffer(other.buffer)
+{
+    // a new reference is taken from an existing one, so nothing has to be ordered
+    if (buffer) {
+        buffer->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template<typename T>
+CowVector<T>::CowVector(CowVector&& other) noexcept
+    : buffer(std::exchange(other.buffer, nullptr))
+{}
+
+template<typename T>
+CowVector<T>::~CowVector()
+{
+    release();
+}
+
+template<typename T>
+CowVector<T>& CowVector<T>::operator=(const CowVector& other) noexcept
+{
+    if (other.buffer) {
+        other.buffer->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    release();
+    buffer = other.buffer;
+    return *this;
+}
+
+template<typename T>
+CowVector<T>& CowVector<T>::operator=(CowVector&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        buffer = std::exchange(other.buffer, nullptr);
+    }
+    return *this;
+}
+
+template<typename T>
+void CowVector<T>::release() noexcept
+{
+    if (buffer && buffer->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete buffer;
+    }
+    buffer = nullptr;
+}
+
+template<typename T>
+const typename CowVector<T>::storage_t& CowVector<T>::view() const noexcept
+{
+    static const storage_t empty_storage;
+    return buffer ? buffer->items : empty_storage;
+}
+
+template<typename T>
+typename CowVector<T>::storage_t& CowVector<T>::mutate()
+{
+    if (!buffer) {
+        buffer = new Buffer{ { 1 }, {} };
+    } else if (is_shared()) {
+        Buffer* own = new Buffer{ { 1 }, buffer->items };
+        release();
+        buffer = own;
+    }
+    return buffer->items;
+}
+
+template<typename T>
+bool CowVector<T>::is_shared() const noexcept
+{
+    return buffer && buffer->refs.load(std::memory_order_acquire) > 1;
+}
+
+template<typename T>
+size_t CowVector<T>::size() const noexcept
+{
+    return buffer ? buffer->items.size() : 0;
+}
+
+template<typename T>
+bool CowVector<T>::empty() const noexcept
+{
+    return !buffer || buffer->items.empty();
+}
+
+template<typename T>
+const T& CowVector<T>::operator[](size_t idx) const noexcept
+{
+    return buffer->items[idx];
+}
+
+template<typename T>
+const T& CowVector<T>::front() const noexcept
+{
+    return buffer->items.front();
+}
+
+template<typename T>
+const T& CowVector<T>::back() const noexcept
+{
+    return buffer->items.back();
+}
+
+template<typename T>
+typename CowVector<T>::const_iterator CowVector<T>::cbegin() const noexcept
+{
+    return view().cbegin();
+}
+
+template<typename T>
+typename CowVector<T>::const_iterator CowVector<T>::cend() const noexcept
+{
+    return view().cend();
+}
+
+template<typename T>
+void CowVector<T>::reserve(size_t capacity)
+{
+    if (capacity > size()) {
+        mutate().reserve(capacity);
+    }
+}
+
+template<typename T>
+void CowVector<T>::resize(size_t size, const T& value)
+{
+    mutate().resize(size, value);
+}
+
+template<typename T>
+void CowVector<T>::clear() noexcept
+{
+    if (is_shared()) {
+        release();
+    } else if (buffer) {
+        buffer->items.clear();
+    }
+}
+
+template<typename T>
+void CowVector<T>::push_back(const T& element)
+{
+    mutate().push_back(element);
+}
+
+template<typename T>
+void CowVector<T>::push_back(T&& element)
+{
+    mutate().push_back(std::move(element));
+}
+
+template<typename T>
+typename CowVector<T>::iterator CowVector<T>::insert(const_iterator pos, const T& element)
+{
+    const auto idx = pos - cbegin();
+    storage_t& own = mutate();
+    return own.insert(own.cbegin() + idx, element);
+}
+
+template<typename T>
+typename CowVector<T>::iterator CowVector<T>::erase(const_iterator pos)
+{
+    const auto idx = pos - cbegin();
+    storage_t& own = mutate();
+    return own.erase(own.cbegin() + idx);
+}
+
+template<typename T>
+typename CowVector<T>::iterator CowVector<T>::erase(const_iterator first, const_iterator last)
+{
+    const auto from = first - cbegin(), to = last - cbegin();
+    storage_t& own = mutate();
+    return own.erase(own.cbegin() + from, own.cbegin() + to);
+}
+
+template<typename T>
+template<typename InputIt>
+void CowVector<T>::assign(InputIt first, InputIt last)
+{
+    // the source may live in the shared storage, so it is never written to
+    if (is_shared()) {
+        Buffer* own = new Buffer{ { 1 }, storage_t(first, last) };
+        release();
+        buffer = own;
+    } else {
+        mutate().assign(first, last);
+    }
+}
+
+template<typename T>
+bool CowVector<T>::operator==(const CowVector& other) const
+{
+    return buffer == other.buffer || view() == other.view();
+}
+
+template<typename T>
+bool CowVector<T>::operator!=(const CowVector& other) const
+{
+    return !(*this == other);
+}
+
+#endif // __COW_VECTOR_H__
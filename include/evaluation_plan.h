@@ -0,0 +1,177 @@
+#ifndef __EVALUATION_PLAN_H__
+#define __EVALUATION_PLAN_H__
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//
+// Immutable nested Horner scheme of a polynomial: Horner in the first variable
+// over the coefficients which are Horner schemes in the rest of the variables,
+// and so on. Only the degrees present are visited, gaps between them are bridged
+// by powers, and the lowest degree (possibly a negative one) is factored out at last.
+// The scheme is flattened into a short stack program, so evaluation is a single
+// pass over contiguous steps with no lookups or recursion
+//
+
+template<size_t NVars>
+class EvaluationPlan {
+public:
+    // -- same as the monomial FixedPoint, coordinates by variable slot
+    typedef std::array<double, NVars> point_t;
+    // -- degrees of every variable and the coefficient, in any order, no duplicate degrees
+    typedef std::vector<std::pair<std::array<int, NVars>, double>> terms_t;
+private:
+    enum class Op : uint8_t {
+        Push,        // push k
+        MulPow,      // top *= x[var]^exp
+        MulPowAdd,   // top = top * x[var]^exp + k, the usual Horner step
+        Add          // pops the top and adds it to the next one
+    };
+
+    struct Step {
+        Op op;
+        uint8_t var;
+        int exp;
+        double k;
+    };
+
+    std::vector<Step> steps;
+
+    typedef typename terms_t::const_iterator term_it;
+
+    // -- emits the scheme of the terms sharing the degrees of the variables preceding var
+    void build(term_it begin, term_it end, size_t var);
+
+    static double power(double x, int exp) noexcept;
+public:
+    explicit EvaluationPlan(terms_t terms);
+
+    [[nodiscard]] double calculate(const point_t& point) const noexcept;
+    double operator()(const point_t& point) const noexcept;
+
+    // -- multiplications by powers performed per evaluation, counting x^e as one step
+    [[nodiscard]] size_t multiplications() const noexcept;
+};
+
+template<size_t NVars>
+EvaluationPlan<NVars>::EvaluationPlan(terms_t terms)
+{
+    static_assert(NVars < 256, "Variable index should fit a byte");
+
+    if (terms.empty()) {
+        steps.push_back({ Op::Push, 0, 0, 0.0 });
+        return;
+    }
+
+    // lexicographically descending, so the terms sharing the leading degrees are adjacent
+    std::sort(terms.begin(), terms.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+    });
+    build(terms.cbegin(), terms.cend(), 0);
+}
+
+template<size_t NVars>
+void EvaluationPlan<NVars>::build(term_it begin, term_it end, size_t var)
+{
+    if (var == NVars) {
+        steps.push_back({ Op::Push, 0, 0, begin->second });
+        return;
+    }
+
+    int prev = 0;
+    bool first = true;
+    for (term_it it = begin; it != end; ) {
+        const int deg = it->first[var];
+        term_it group = it;
+        while (group != end && group->first[var] == deg) {
+            ++group;
+        }
+
+        if (first) {
+            build(it, group, var + 1);
+        } else if (var + 1 == NVars) {
+            // the coefficient is a constant, so the step is fused with its addition
+            steps.push_back({ Op::MulPowAdd, static_cast<uint8_t>(var), prev - deg, it->second });
+        } else {
+            steps.push_back({ Op::MulPow, static_cast<uint8_t>(var), prev - deg, 0.0 });
+            build(it, group, var + 1);
+            steps.push_back({ Op::Add, 0, 0, 0.0 });
+        }
+
+        prev = deg;
+        first = false;
+        it = group;
+    }
+
+    if (prev != 0) {
+        steps.push_back({ Op::MulPow, static_cast<uint8_t>(var), prev, 0.0 });
+    }
+}
+
+template<size_t NVars>
+double EvaluationPlan<NVars>::power(double x, int exp) noexcept
+{
+    if (exp == 1)
+        return x;
+
+    if (exp < 0) {
+        x = 1.0 / x;
+        exp = -exp;
+    }
+
+    double res = 1.0;
+    for (; exp; exp >>= 1) {
+        if (exp & 1) {
+            res *= x;
+        }
+        x *= x;
+    }
+    return res;
+}
+
+template<size_t NVars>
+double EvaluationPlan<NVars>::calculate(const point_t& point) const noexcept
+{
+    // a variable keeps at most one partial result on the stack
+    double stack[NVars + 1];
+    size_t top = 0;
+
+    for (const Step& step : steps) {
+        switch (step.op) {
+            case Op::Push:
+                stack[top++] = step.k;
+                break;
+            case Op::MulPow:
+                stack[top - 1] *= power(point[step.var], step.exp);
+                break;
+            case Op::MulPowAdd:
+                stack[top - 1] = stack[top - 1] * power(point[step.var], step.exp) + step.k;
+                break;
+            case Op::Add:
+                top--;
+                stack[top - 1] += stack[top];
+                break;
+        }
+    }
+
+    return stack[0];
+}
+
+template<size_t NVars>
+double EvaluationPlan<NVars>::operator()(const point_t& point) const noexcept
+{
+    return calculate(point);
+}
+
+template<size_t NVars>
+size_t EvaluationPlan<NVars>::multiplications() const noexcept
+{
+    return std::count_if(steps.cbegin(), steps.cend(), [](const Step& step) {
+        return step.op == Op::MulPow || step.op == Op::MulPowAdd;
+    });
+}
+
+#endif // __EVALUATION_PLAN_H__
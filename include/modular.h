@@ -0,0 +1,319 @@
+#ifndef __MODULAR_H__
+#define __MODULAR_H__
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#if defined(_MSC_VER) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+#include "coefficients.h"
+
+namespace Modular {
+    // -- high and low halves of the full 128 bit product
+    inline uint64_t mul_wide(uint64_t a, uint64_t b, uint64_t& lo) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+        lo = static_cast<uint64_t>(p);
+        return static_cast<uint64_t>(p >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        uint64_t hi;
+        lo = _umul128(a, b, &hi);
+        return hi;
+#else
+        const uint64_t a_lo = static_cast<uint32_t>(a), a_hi = a >> 32;
+        const uint64_t b_lo = static_cast<uint32_t>(b), b_hi = b >> 32;
+        const uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+        const uint64_t mid = (ll >> 32) + static_cast<uint32_t>(lh) + static_cast<uint32_t>(hl);
+        lo = (mid << 32) | static_cast<uint32_t>(ll);
+        return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+    }
+
+    // -- the largest prime below 2^63
+    static constexpr uint64_t PRIME_63 = 9223372036854775783ull;
+}
+
+//
+// Residue modulo an odd prime below 2^63, kept in the Montgomery form a * 2^64 mod p,
+// so a product costs a couple of wide multiplications instead of a 128 bit division.
+// Sums of two residues can not overflow a word, so they only need a conditional subtraction.
+// Every prime is a type of its own, products modulo different primes share nothing
+// and may run on separate threads, to be recombined by CRT afterwards
+//
+
+template<uint64_t Modulus>
+class MontgomeryInt {
+    static_assert(Modulus % 2 == 1 && Modulus > 2 && Modulus < (uint64_t(1) << 63),
+                  "Modulus should be an odd prime below 2^63");
+private:
+    // -- p^-1 mod 2^64 by Newton iteration, every step doubles the number of correct bits
+    static constexpr uint64_t INV = [] {
+        uint64_t inv = Modulus; // correct in the lowest 3 bits already
+        for (int i = 0; i < 5; i++) {
+            inv *= 2 - Modulus * inv;
+        }
+        return inv;
+    }();
+
+    // -- 2^128 mod p, converts to the Montgomery form
+    static constexpr uint64_t R2 = [] {
+        uint64_t r = (0 - Modulus) % Modulus;
+        for (int i = 0; i < 64; i++) {
+            r = (r << 1) >= Modulus ? (r << 1) - Modulus : r << 1;
+        }
+        return r;
+    }();
+
+    uint64_t value = 0;
+
+    // -- (hi * 2^64 + lo) / 2^64 mod p, for inputs below p * 2^64
+    static uint64_t reduce(uint64_t hi, uint64_t lo) noexcept;
+    static uint64_t mul_reduce(uint64_t a, uint64_t b) noexcept;
+    static MontgomeryInt from_montgomery(uint64_t value) noexcept;
+public:
+    static constexpr uint64_t MODULUS = Modulus;
+
+    MontgomeryInt(int64_t value = 0) noexcept;
+
+    // -- in [0, p)
+    [[nodiscard]] uint64_t residue() const noexcept;
+    // -- in (-p / 2, p / 2], the representative small integers map back to
+    [[nodiscard]] int64_t to_signed() const noexcept;
+
+    [[nodiscard]] bool is_zero() const noexcept;
+    [[nodiscard]] MontgomeryInt pow(uint64_t exp) const noexcept;
+    // -- by Fermat's little theorem, throws for zero
+    [[nodiscard]] MontgomeryInt inverse() const;
+
+    bool operator==(const MontgomeryInt& other) const noexcept;
+    bool operator!=(const MontgomeryInt& other) const noexcept;
+
+    MontgomeryInt operator-() const noexcept;
+    //
+    MontgomeryInt operator+(const MontgomeryInt& other) const noexcept;
+    MontgomeryInt& operator+=(const MontgomeryInt& other) noexcept;
+    //
+    MontgomeryInt operator-(const MontgomeryInt& other) const noexcept;
+    MontgomeryInt& operator-=(const MontgomeryInt& other) noexcept;
+    //
+    MontgomeryInt operator*(const MontgomeryInt& other) const noexcept;
+    MontgomeryInt& operator*=(const MontgomeryInt& other) noexcept;
+    //
+    MontgomeryInt operator/(const MontgomeryInt& other) const;
+    MontgomeryInt& operator/=(const MontgomeryInt& other);
+
+    friend std::ostream& operator<<(std::ostream& os, const MontgomeryInt& k)
+    {
+        return os << k.residue();
+    }
+};
+
+using Mod63 = MontgomeryInt<Modular::PRIME_63>;
+
+template<uint64_t Modulus>
+struct CoefficientTraits<MontgomeryInt<Modulus>> {
+    typedef MontgomeryInt<Modulus> value_t;
+
+    static constexpr bool APPROXIMATE = false;
+
+    static bool is_zero(const value_t& k) noexcept { return k.is_zero(); }
+    // -- residues have no sign, they are printed as they are
+    static bool is_negative(const value_t&) noexcept { return false; }
+    static double to_double(const value_t& k) noexcept { return static_cast<double>(k.to_signed()); }
+    static uint64_t hash(const value_t& k) noexcept { return k.residue(); }
+
+    // -- decimal integers and fractions "p/q", reduced on the fly, so any length fits
+    template<class Reader>
+    static bool read(Reader& reader, value_t& k)
+    {
+        if (reader.peek() < '0' || reader.peek() > '9')
+            return false;
+
+        const auto read_integer = [&reader] {
+            value_t res;
+            for (char c = reader.peek(); c >= '0' && c <= '9'; c = reader.peek()) {
+                res = res * value_t(10) + value_t(c - '0');
+                reader.skip();
+            }
+            return res;
+        };
+
+        k = read_integer();
+        if (reader.peek() == '/') {
+            reader.skip();
+            if (reader.peek() < '0' || reader.peek() > '9')
+                throw std::invalid_argument("Invalid fraction denominator");
+            k /= read_integer();
+        }
+        return true;
+    }
+};
+
+// region Montgomery Arithmetic
+
+template<uint64_t Modulus>
+uint64_t MontgomeryInt<Modulus>::reduce(uint64_t hi, uint64_t lo) noexcept
+{
+    // m * p matches the input in the low word, so subtracting leaves a multiple of 2^64
+    const uint64_t m = lo * INV;
+    uint64_t mp_lo;
+    const uint64_t mp_hi = Modular::mul_wide(m, Modulus, mp_lo);
+    return hi >= mp_hi ? hi - mp_hi : hi + (Modulus - mp_hi);
+}
+
+template<uint64_t Modulus>
+uint64_t MontgomeryInt<Modulus>::mul_reduce(uint64_t a, uint64_t b) noexcept
+{
+    uint64_t lo;
+    const uint64_t hi = Modular::mul_wide(a, b, lo);
+    return reduce(hi, lo);
+}
+
+template<uint64_t Modulus>
+MontgomeryInt<Modulus> MontgomeryInt<Modulus>::from_montgomery(uint64_t value) noexcept
+{
+    MontgomeryInt res;
+    res.value = value;
+    return res;
+}
+
+template<uint64_t Modulus>
+MontgomeryInt<Modulus>::MontgomeryInt(int64_t value) noexcept
+{
+    const uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    uint64_t r = magnitude % Modulus;
+    if (value < 0 && r != 0) {
+        r = Modulus - r;
+    }
+    this->value = mul_reduce(r, R2);
+}
+
+template<uint64_t Modulus>
+uint64_t MontgomeryInt<Modulus>::residue() const noexcept
+{
+    return reduce(0, value);
+}
+
+template<uint64_t Modulus>
+int64_t MontgomeryInt<Modulus>::to_signed() const noexcept
+{
+    const uint64_t r = residue();
+    return r > Modulus / 2 ? -static_cast<int64_t>(Modulus - r) : static_cast<int64_t>(r);
+}
+
+template<uint64_t Modulus>
+bool MontgomeryInt<Modulus>::is_zero() const noexcept
+{
+    // zero is the only residue with zero Montgomery form
+    return value == 0;
+}
+
+template<uint64_t Modulus>
+MontgomeryInt<Modulus> MontgomeryInt<Modulus>::pow(uint64_t exp) const noexcept
+{
+    MontgomeryInt res(1), base(*this);
+    for (; exp; exp >>= 1) {
+        if (exp & 1) {
+            res *= base;
+        }
+        base *= base;
+    }
+    return res;
+}
+
+template<uint64_t Modulus>
+MontgomeryInt<Modulus> MontgomeryInt<Modulus>::inverse() const
+{
+    if (is_zero()) {
+        throw std::domain_error("Division by zero");
+    }
+    return pow(Modulus - 2);
+}
+
+template<uint64_t Modulus>
+bool MontgomeryInt<Modulus>::operator==(const MontgomeryInt& other) const noexcept
+{
+    return value == other.value;
+}
+
+template<uint64_t Modulus>
+bool MontgomeryInt<Modulus>::operator!=(const MontgomeryInt& other) const noexcept
+{
+    return value != other.value;
+}
+
+template<uint64_t Modulus>
+MontgomeryInt<Modulus> MontgomeryInt<Modulus>::operator-() const noexcept
+{
+    return from_montgomery(value ? Modulus - value : 0);
+}
+
+//
+
+template<uint64_t Modulus>
+MontgomeryInt<Modulus> MontgomeryInt<Modulus>::operator+(const MontgomeryInt& other) const noexcept
+{
+    MontgomeryInt res(*this);
+    return res += other;
+}
+template<uint64_t Modulus>
+MontgomeryInt<Modulus>& MontgomeryInt<Modulus>::operator+=(const MontgomeryInt& other) noexcept
+{
+    // both are below 2^63, so the sum fits
+    value += other.value;
+    if (value >= Modulus) {
+        value -= Modulus;
+    }
+    return *this;
+}
+
+//
+
+template<uint64_t Modulus>
+MontgomeryInt<Modulus> MontgomeryInt<Modulus>::operator-(const MontgomeryInt& other) const noexcept
+{
+    MontgomeryInt res(*this);
+    return res -= other;
+}
+template<uint64_t Modulus>
+MontgomeryInt<Modulus>& MontgomeryInt<Modulus>::operator-=(const MontgomeryInt& other) noexcept
+{
+    value = value >= other.value ? value - other.value : value + (Modulus - other.value);
+    return *this;
+}
+
+//
+
+template<uint64_t Modulus>
+MontgomeryInt<Modulus> MontgomeryInt<Modulus>::operator*(const MontgomeryInt& other) const noexcept
+{
+    return from_montgomery(mul_reduce(value, other.value));
+}
+template<uint64_t Modulus>
+MontgomeryInt<Modulus>& MontgomeryInt<Modulus>::operator*=(const MontgomeryInt& other) noexcept
+{
+    value = mul_reduce(value, other.value);
+    return *this;
+}
+
+//
+
+template<uint64_t Modulus>
+MontgomeryInt<Modulus> MontgomeryInt<Modulus>::operator/(const MontgomeryInt& other) const
+{
+    return *this * other.inverse();
+}
+template<uint64_t Modulus>
+MontgomeryInt<Modulus>& MontgomeryInt<Modulus>::operator/=(const MontgomeryInt& other)
+{
+    return *this *= other.inverse();
+}
+
+// endregion
+
+#endif // __MODULAR_H__
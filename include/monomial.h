@@ -0,0 +1,860 @@
+#ifndef __MONOMIAL_H__
+#define __MONOMIAL_H__
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <array>
+
+#include "coefficients.h"
+#include "parsingexcept.h"
+#include "reader.h"
+
+template<typename MonomialT>
+class BasicPolynomial;
+
+// region Monomial Orders
+
+//
+// Term orders, each one is a layout of the packed degrees
+// that makes a single unsigned comparison of the words follow the order
+//
+
+namespace MonomialOrder {
+    // -- lexicographic, x > y > z
+    struct Lex {
+        static constexpr bool GRADED = false;
+        static constexpr bool REVERSED = false;
+    };
+
+    // -- total degree first, ties are broken lexicographically
+    struct GradedLex {
+        static constexpr bool GRADED = true;
+        static constexpr bool REVERSED = false;
+    };
+
+    // -- total degree first, then the smaller degree of the last variable wins, and so on
+    struct GradedReverseLex {
+        static constexpr bool GRADED = true;
+        static constexpr bool REVERSED = true;
+    };
+}
+
+// endregion
+
+//
+// Degrees of all the variables packed into unsigned machine words, lane per variable.
+// The first variable occupies the most significant lane (the last one for the reversed
+// orders), graded orders also keep the total degree in a double-width field on top,
+// so comparing the words (starting from the most significant one) yields the order.
+// Lanes are stored as unsigned, hence negative degrees compare as the largest ones
+//
+
+template<size_t NVars, typename DegreeT, typename Order>
+struct PackedDegrees {
+    static_assert(std::is_integral_v<DegreeT> && sizeof(DegreeT) <= sizeof(uint32_t),
+                  "Degrees should be integers of at most 32 bits");
+
+    typedef DegreeT value_t;
+    typedef std::make_unsigned_t<DegreeT> lane_t;
+
+    static constexpr size_t TOTAL_LANES = Order::GRADED ? 2 : 0;
+    static constexpr size_t BYTES = (NVars + TOTAL_LANES) * sizeof(value_t);
+
+    // -- a single 32 or 64 bit word while the degrees fit into it, an array of 64 bit words beyond that
+    typedef std::conditional_t<BYTES <= sizeof(uint32_t), uint32_t, uint64_t> word_t;
+
+    static constexpr size_t LANE_BITS = 8 * sizeof(value_t);
+    static constexpr size_t LANES_PER_WORD = sizeof(word_t) / sizeof(value_t);
+    static constexpr size_t WORDS = (NVars + TOTAL_LANES + LANES_PER_WORD - 1) / LANES_PER_WORD;
+
+    // -- sum of up to 26 degrees never overflows the double-width field
+    typedef std::conditional_t<LANE_BITS == 8, int16_t, std::conditional_t<LANE_BITS == 16, int32_t, int64_t>> signed_total_t;
+    typedef std::conditional_t<std::is_signed_v<value_t>, signed_total_t, std::make_unsigned_t<signed_total_t>> total_t;
+
+    // -- the least significant word goes first
+    word_t packed[WORDS];
+private:
+    static constexpr size_t TOTAL_SHIFT = (LANES_PER_WORD - TOTAL_LANES) * LANE_BITS;
+
+    static constexpr size_t lane_of(size_t component) noexcept
+    {
+        return Order::REVERSED ? component : NVars - 1 - component;
+    }
+
+    // -- sign bit of every field
+    static constexpr std::array<word_t, WORDS> HIGH_BITS = [] {
+        std::array<word_t, WORDS> masks = {};
+        for (size_t w = 0; w < WORDS; w++) {
+            for (size_t i = 0; i < LANES_PER_WORD; i++) {
+                // lower half of the total degree field
+                if (TOTAL_LANES && w == WORDS - 1 && i == LANES_PER_WORD - TOTAL_LANES)
+                    continue;
+                masks[w] |= word_t(1) << (i * LANE_BITS + LANE_BITS - 1);
+            }
+        }
+        return masks;
+    }();
+
+    // -- reversed orders compare the variables lanes inverted
+    static constexpr std::array<word_t, WORDS> FLIP_BITS = [] {
+        std::array<word_t, WORDS> masks = {};
+        for (size_t l = 0; Order::REVERSED && l < NVars; l++) {
+            masks[l / LANES_PER_WORD] |= static_cast<word_t>(std::numeric_limits<lane_t>::max())
+                    << ((l % LANES_PER_WORD) * LANE_BITS);
+        }
+        return masks;
+    }();
+public:
+    // -- lane-wise arithmetic over whole words, false on overflow of any lane (dst is left intact then)
+    static bool add_to(PackedDegrees& dst, const PackedDegrees& other) noexcept;
+    static bool subtract_from(PackedDegrees& dst, const PackedDegrees& other) noexcept;
+
+    [[nodiscard]] value_t get(size_t component) const noexcept;
+    void set(size_t component, value_t deg) noexcept;
+    [[nodiscard]] int64_t total() const noexcept;
+
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] uint64_t hash() const noexcept;
+    // -- every lane is at most the one of other, compared as unsigned
+    [[nodiscard]] bool divides(const PackedDegrees& other) const noexcept;
+
+    bool operator==(const PackedDegrees& other) const noexcept;
+    bool operator!=(const PackedDegrees& other) const noexcept;
+
+    bool operator<(const PackedDegrees& other) const noexcept;
+    bool operator>(const PackedDegrees& other) const noexcept;
+};
+
+template<size_t NVars = 3, typename DegreeT = char, typename Order = MonomialOrder::Lex, typename CoeffT = double>
+class BasicMonomial {
+    template<typename>
+    friend class BasicPolynomial;
+public:
+    static_assert(NVars > 0 && NVars <= 'z' - 'a' + 1, "Variables should be named by lowercase latin letters");
+
+    static constexpr size_t COMPONENTS = NVars;
+
+    typedef Order order_t;
+    typedef CoeffT coeff_t;
+    typedef CoefficientTraits<CoeffT> coeff_traits;
+
+    typedef PackedDegrees<NVars, DegreeT, Order> Degrees;
+private:
+    coeff_t k;
+    Degrees degs;
+
+    template<class Reader>
+    void parse(Reader& reader);
+
+    template<typename Operation>
+    static BasicMonomial apply_sum(const BasicMonomial& m1, const BasicMonomial& m2, Operation op);
+    template<typename Operation>
+    static void apply_sum_to(BasicMonomial& dst, const BasicMonomial& other, Operation op);
+    //
+    template<typename OperationCoefficient, typename OperationDegree>
+    static BasicMonomial apply_mult(const BasicMonomial& m1, const BasicMonomial& m2, OperationCoefficient opK, OperationDegree opDeg);
+    template<typename OperationCoefficient, typename OperationDegree>
+    static void apply_mult_to(BasicMonomial& dst, const BasicMonomial& other, OperationCoefficient opK, OperationDegree opDeg);
+
+    static bool verify_degree(int deg) noexcept;
+    static bool verify_variable(char var) noexcept;
+
+    BasicMonomial(coeff_t k, Degrees degs);
+public:
+    static constexpr char VAR_MAX = 'z';
+    static constexpr char VAR_MIN = VAR_MAX - NVars + 1;
+
+    typedef std::unordered_map<char, double> Point;
+    // -- coordinates of all the variables by slot, see slot(), e.g. { x, y, z }
+    typedef std::array<double, NVars> FixedPoint;
+
+    static constexpr size_t slot(char var) noexcept { return static_cast<size_t>(var - VAR_MIN); }
+
+    static constexpr int DEGREE_MIN = std::numeric_limits<typename Degrees::value_t>::min();
+    static constexpr int DEGREE_MAX = std::numeric_limits<typename Degrees::value_t>::max();
+
+    explicit BasicMonomial(const std::string& raw);
+    explicit BasicMonomial(const char* raw);
+    explicit BasicMonomial(coeff_t k);
+    BasicMonomial(coeff_t k, const std::array<int, NVars>& degs);
+
+    // -- degrees of all the variables in order, e.g. Monomial(k, degX, degY, degZ)
+    template<typename... Degs, typename = std::enable_if_t<
+            sizeof...(Degs) == NVars && std::conjunction_v<std::is_integral<Degs>...>>>
+    BasicMonomial(coeff_t k, Degs... degs)
+        : BasicMonomial(std::move(k), std::array<int, NVars>{ static_cast<int>(degs)... })
+    {}
+
+    [[nodiscard]]
+    const coeff_t& coefficient() const noexcept;
+    void set_coefficient(coeff_t coefficient) noexcept;
+
+    [[nodiscard]] bool cmp_degs(const BasicMonomial& other) const noexcept;
+    [[nodiscard]] bool has_degs() const noexcept;
+    // -- other / *this has no negative degrees, for the monomials with non-negative ones
+    [[nodiscard]] bool divides(const BasicMonomial& other) const noexcept;
+    [[nodiscard]] int64_t total_degree() const noexcept;
+    // -- of the degrees and the coefficient, consistent with ==
+    [[nodiscard]] uint64_t hash() const noexcept;
+
+    typename Degrees::value_t operator[](char var) const noexcept;
+    void set_degree(char var, int deg);
+
+    // -- evaluated in doubles, whatever the coefficient type is
+    [[nodiscard]]
+    double calculate(const Point& point) const;
+    // -- allocation-free, gives the same result as the map overload
+    [[nodiscard]]
+    double calculate(const FixedPoint& point) const noexcept;
+
+    [[nodiscard]] BasicMonomial differentiate(char variable) const;
+    [[nodiscard]] BasicMonomial integrate(char variable) const;
+
+    bool operator<(const BasicMonomial& other) const;
+    bool operator>(const BasicMonomial& other) const;
+    bool operator==(const BasicMonomial& other) const;
+    bool operator!=(const BasicMonomial& other) const;
+
+    BasicMonomial operator-() const;
+    //
+    BasicMonomial operator+(const BasicMonomial& other) const;
+    BasicMonomial& operator+=(const BasicMonomial& other);
+    //
+    BasicMonomial operator-(const BasicMonomial& other) const;
+    BasicMonomial& operator-=(const BasicMonomial& other);
+    //
+    BasicMonomial operator*(const BasicMonomial& other) const;
+    BasicMonomial& operator*=(const BasicMonomial& other);
+    //
+    BasicMonomial operator/(const BasicMonomial& other) const;
+    BasicMonomial& operator/=(const BasicMonomial& other);
+    //
+    // -- by squaring, throws when the degrees get out of range as the multiplication does
+    [[nodiscard]] BasicMonomial pow(unsigned exponent) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const BasicMonomial& m)
+    {
+        if (m.degs.empty() || (m.k != coeff_t(1) && m.k != coeff_t(-1))) {
+            os << m.k;
+        }
+
+        typename Degrees::value_t deg;
+        for (char var = VAR_MIN; var <= VAR_MAX; var++)
+        {
+            deg = m[var];
+            if (deg == 0)
+                continue;
+
+            os << var;
+            if (deg != 1) {
+                os << "^" << static_cast<int>(deg);
+            }
+        }
+
+        return os;
+    }
+};
+
+using Monomial = BasicMonomial<3, char, MonomialOrder::Lex, double>;
+
+// region Degrees
+
+template<size_t NVars, typename DegreeT, typename Order>
+typename PackedDegrees<NVars, DegreeT, Order>::value_t PackedDegrees<NVars, DegreeT, Order>::get(size_t component) const noexcept
+{
+    const size_t lane = lane_of(component);
+    const word_t word = packed[lane / LANES_PER_WORD] >> ((lane % LANES_PER_WORD) * LANE_BITS);
+    return static_cast<value_t>(static_cast<lane_t>(word));
+}
+
+template<size_t NVars, typename DegreeT, typename Order>
+void PackedDegrees<NVars, DegreeT, Order>::set(size_t component, value_t deg) noexcept
+{
+    const size_t lane = lane_of(component);
+    const size_t shift = (lane % LANES_PER_WORD) * LANE_BITS;
+
+    if constexpr (Order::GRADED) {
+        // the total degree field is kept in sync, wrapping the same way the lanes do
+        typedef std::make_unsigned_t<total_t> field_t;
+        const auto total = static_cast<field_t>(static_cast<field_t>(this->total()) + deg - get(component));
+        word_t& top = packed[WORDS - 1];
+        top &= ~(static_cast<word_t>(std::numeric_limits<field_t>::max()) << TOTAL_SHIFT);
+        top |= static_cast<word_t>(total) << TOTAL_SHIFT;
+    }
+
+    word_t& word = packed[lane / LANES_PER_WORD];
+    word &= ~(static_cast<word_t>(std::numeric_limits<lane_t>::max()) << shift);
+    word |= static_cast<word_t>(static_cast<lane_t>(deg)) << shift;
+}
+
+template<size_t NVars, typename DegreeT, typename Order>
+int64_t PackedDegrees<NVars, DegreeT, Order>::total() const noexcept
+{
+    if constexpr (Order::GRADED) {
+        typedef std::make_unsigned_t<total_t> field_t;
+        return static_cast<total_t>(static_cast<field_t>(packed[WORDS - 1] >> TOTAL_SHIFT));
+    } else {
+        int64_t total = 0;
+        for (size_t c = 0; c < NVars; c++) {
+            total += get(c);
+        }
+        return total;
+    }
+}
+
+//
+// SWAR: the high bits are masked out so the carries can not cross the lanes,
+// then restored with a xor. Overflow of a signed lane means both operands
+// agree on the sign the result does not have (a carry out of an unsigned lane),
+// so a single test of the masked words detects it for all the lanes at once
+//
+
+template<size_t NVars, typename DegreeT, typename Order>
+bool PackedDegrees<NVars, DegreeT, Order>::add_to(PackedDegrees& dst, const PackedDegrees& other) noexcept
+{
+    word_t res[WORDS];
+    word_t overflow = 0;
+
+    for (size_t i = 0; i < WORDS; i++) {
+        const word_t a = dst.packed[i], b = other.packed[i];
+        const word_t h = HIGH_BITS[i];
+        const word_t s = ((a & ~h) + (b & ~h)) ^ ((a ^ b) & h);
+
+        if constexpr (std::is_signed_v<value_t>) {
+            overflow |= ~(a ^ b) & (a ^ s) & h;
+        } else {
+            overflow |= ((a & b) | ((a | b) & ~s)) & h;
+        }
+        res[i] = s;
+    }
+
+    if (overflow)
+        return false;
+
+    std::copy(std::begin(res), std::end(res), std::begin(dst.packed));
+    return true;
+}
+
+template<size_t NVars, typename DegreeT, typename Order>
+bool PackedDegrees<NVars, DegreeT, Order>::subtract_from(PackedDegrees& dst, const PackedDegrees& other) noexcept
+{
+    word_t res[WORDS];
+    word_t overflow = 0;
+
+    for (size_t i = 0; i < WORDS; i++) {
+        const word_t a = dst.packed[i], b = other.packed[i];
+        const word_t h = HIGH_BITS[i];
+        const word_t d = ((a | h) - (b & ~h)) ^ ((a ^ ~b) & h);
+
+        if constexpr (std::is_signed_v<value_t>) {
+            overflow |= (a ^ b) & (a ^ d) & h;
+        } else {
+            overflow |= ((~a & b) | (~(a ^ b) & d)) & h;
+        }
+        res[i] = d;
+    }
+
+    if (overflow)
+        return false;
+
+    std::copy(std::begin(res), std::end(res), std::begin(dst.packed));
+    return true;
+}
+
+template<size_t NVars, typename DegreeT, typename Order>
+bool PackedDegrees<NVars, DegreeT, Order>::divides(const PackedDegrees& other) const noexcept
+{
+    // unsigned lane-wise other - *this, a borrow out of any lane means that lane is greater here
+    for (size_t i = 0; i < WORDS; i++) {
+        const word_t a = other.packed[i], b = packed[i];
+        const word_t h = HIGH_BITS[i];
+        const word_t d = ((a | h) - (b & ~h)) ^ ((a ^ ~b) & h);
+
+        if (((~a & b) | (~(a ^ b) & d)) & h)
+            return false;
+    }
+    return true;
+}
+
+template<size_t NVars, typename DegreeT, typename Order>
+bool PackedDegrees<NVars, DegreeT, Order>::empty() const noexcept
+{
+    for (size_t i = 0; i < WORDS; i++) {
+        if (packed[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+template<size_t NVars, typename DegreeT, typename Order>
+uint64_t PackedDegrees<NVars, DegreeT, Order>::hash() const noexcept
+{
+    // fibonacci hashing spreads the neighbouring packed degrees
+    uint64_t h = 0;
+    for (size_t i = 0; i < WORDS; i++) {
+        h = (h ^ packed[i]) * 0x9E3779B97F4A7C15ull;
+    }
+    return h;
+}
+
+template<size_t NVars, typename DegreeT, typename Order>
+bool PackedDegrees<NVars, DegreeT, Order>::operator==(const PackedDegrees& other) const noexcept
+{
+    for (size_t i = 0; i < WORDS; i++) {
+        if (packed[i] != other.packed[i])
+            return false;
+    }
+    return true;
+}
+
+template<size_t NVars, typename DegreeT, typename Order>
+bool PackedDegrees<NVars, DegreeT, Order>::operator!=(const PackedDegrees& other) const noexcept
+{
+    return !(*this == other);
+}
+
+template<size_t NVars, typename DegreeT, typename Order>
+bool PackedDegrees<NVars, DegreeT, Order>::operator<(const PackedDegrees& other) const noexcept
+{
+    for (size_t i = WORDS; i-- > 1; ) {
+        if (packed[i] != other.packed[i])
+            return (packed[i] ^ FLIP_BITS[i]) < (other.packed[i] ^ FLIP_BITS[i]);
+    }
+    return (packed[0] ^ FLIP_BITS[0]) < (other.packed[0] ^ FLIP_BITS[0]);
+}
+
+template<size_t NVars, typename DegreeT, typename Order>
+bool PackedDegrees<NVars, DegreeT, Order>::operator>(const PackedDegrees& other) const noexcept
+{
+    return other < *this;
+}
+
+// endregion
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+bool BasicMonomial<NVars, DegreeT, Order, CoeffT>::verify_degree(int deg) noexcept
+{
+    return (deg >= DEGREE_MIN) && (deg <= DEGREE_MAX);
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+bool BasicMonomial<NVars, DegreeT, Order, CoeffT>::verify_variable(char var) noexcept
+{
+    return (var >= VAR_MIN) && (var <= VAR_MAX);
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT>::BasicMonomial(coeff_t k, Degrees degs)
+    : k(std::move(k))
+    , degs(degs)
+{}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT>::BasicMonomial(coeff_t k)
+    : k(std::move(k))
+    , degs({ 0 })
+{}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+template<class Reader>
+void BasicMonomial<NVars, DegreeT, Order, CoeffT>::parse(Reader& reader)
+{
+    static_assert(std::is_base_of<MonomialReader, Reader>::value, "Reader should inherit from MonomialReader");
+
+    const int sign = reader.peek() == '-' ? -1 : 1;
+    if (reader.peek() == '-' || reader.peek() == '+')
+    {
+        reader.skip();
+    }
+
+    while (reader.peek() == ' ')
+    {
+        reader.skip();
+    }
+
+    if (!coeff_traits::read(reader, k))
+    {
+        reader.clr_err();
+        k = coeff_t(1);
+    }
+    if (sign < 0) {
+        k = -k;
+    }
+
+    char var;
+    int deg;
+
+    while (reader.read_char(var))
+    {
+        if (var == ' ')
+            continue;
+
+        if (var < VAR_MIN || var > VAR_MAX)
+        {
+            throw expression_parse_error("Unsupported monomial variable");
+        }
+
+        if (reader.peek() == '^')
+        {
+            reader.skip();
+
+            if (!reader.read_int(deg) || deg < DEGREE_MIN || deg > DEGREE_MAX)
+            {
+                throw expression_parse_error("Invalid monomial component degree");
+            }
+        }
+        else
+        {
+            deg = 1;
+        }
+
+        degs.set(var - VAR_MIN, static_cast<typename Degrees::value_t>(deg));
+    }
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT>::BasicMonomial(coeff_t k, const std::array<int, NVars>& degs)
+    : k(std::move(k))
+    , degs({ 0 })
+{
+    for (int deg : degs) {
+        if (!verify_degree(deg)) {
+            throw std::invalid_argument("Degrees are out of range");
+        }
+    }
+
+    for (size_t c = 0; c < NVars; c++) {
+        this->degs.set(c, static_cast<typename Degrees::value_t>(degs[c]));
+    }
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT>::BasicMonomial(const char* raw)
+    : k(0)
+    , degs({ 0 })
+{
+    auto parser = PStrMonomialReader(raw);
+    parse(parser);
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT>::BasicMonomial(const std::string &raw)
+    : k(0)
+    , degs({ 0 })
+{
+    auto parser = StringMonomialReader(raw);
+    parse(parser);
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+const CoeffT& BasicMonomial<NVars, DegreeT, Order, CoeffT>::coefficient() const noexcept
+{
+    return k;
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+void BasicMonomial<NVars, DegreeT, Order, CoeffT>::set_coefficient(coeff_t coefficient) noexcept
+{
+    k = std::move(coefficient);
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+bool BasicMonomial<NVars, DegreeT, Order, CoeffT>::cmp_degs(const BasicMonomial& other) const noexcept
+{
+    return degs == other.degs;
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+bool BasicMonomial<NVars, DegreeT, Order, CoeffT>::has_degs() const noexcept
+{
+    return !degs.empty();
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+bool BasicMonomial<NVars, DegreeT, Order, CoeffT>::divides(const BasicMonomial& other) const noexcept
+{
+    return degs.divides(other.degs);
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+int64_t BasicMonomial<NVars, DegreeT, Order, CoeffT>::total_degree() const noexcept
+{
+    return degs.total();
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+uint64_t BasicMonomial<NVars, DegreeT, Order, CoeffT>::hash() const noexcept
+{
+    return Hashing::combine(degs.hash(), coeff_traits::hash(k));
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+typename BasicMonomial<NVars, DegreeT, Order, CoeffT>::Degrees::value_t BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator[](char var) const noexcept
+{
+    return degs.get(var - VAR_MIN);
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+void BasicMonomial<NVars, DegreeT, Order, CoeffT>::set_degree(char var, int deg)
+{
+    if (!verify_variable(var)) {
+        throw std::invalid_argument("Non-existent variable");
+    }
+    if (!verify_degree(deg)) {
+        throw std::invalid_argument("Degrees are out of range");
+    }
+
+    degs.set(var - VAR_MIN, static_cast<typename Degrees::value_t>(deg));
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+double BasicMonomial<NVars, DegreeT, Order, CoeffT>::calculate(const Point& point) const
+{
+    if (coeff_traits::is_zero(k)) {
+        return 0;
+    }
+
+    double res = coeff_traits::to_double(k);
+
+    typename Degrees::value_t deg;
+    for (char var = VAR_MIN; var <= VAR_MAX; var++)
+    {
+        deg = (*this)[var];
+        if (deg == 0)
+            continue;
+
+        const auto it = point.find(var);
+        if (it == point.end())
+            throw std::invalid_argument("Incomplete point, missing a component");
+
+        res *= std::pow(it->second, deg);
+    }
+
+    return res;
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+double BasicMonomial<NVars, DegreeT, Order, CoeffT>::calculate(const FixedPoint& point) const noexcept
+{
+    if (coeff_traits::is_zero(k)) {
+        return 0;
+    }
+
+    double res = coeff_traits::to_double(k);
+    for (size_t c = 0; c < NVars; c++) {
+        const auto deg = degs.get(c);
+        if (deg != 0) {
+            res *= std::pow(point[c], deg);
+        }
+    }
+
+    return res;
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT> BasicMonomial<NVars, DegreeT, Order, CoeffT>::differentiate(char var) const
+{
+    if (!verify_variable(var)) {
+        throw std::invalid_argument("Non-existent variable");
+    }
+
+    BasicMonomial m(*this);
+    const auto deg = m[var];
+    m.k *= coeff_t(deg);
+    m.degs.set(var - VAR_MIN, static_cast<typename Degrees::value_t>(deg - 1));
+
+    return m;
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT> BasicMonomial<NVars, DegreeT, Order, CoeffT>::integrate(char var) const
+{
+    if (!verify_variable(var)) {
+        throw std::invalid_argument("Non-existent variable");
+    }
+
+    BasicMonomial m(*this);
+    const auto deg = static_cast<typename Degrees::value_t>(m[var] + 1);
+    m.degs.set(var - VAR_MIN, deg);
+    m.k /= coeff_t(deg);
+
+    return m;
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+bool BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator<(const BasicMonomial& other) const
+{
+    return degs < other.degs;
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+bool BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator>(const BasicMonomial& other) const
+{
+    return degs > other.degs;
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+bool BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator==(const BasicMonomial& other) const
+{
+    return (k == other.k) && (degs == other.degs);
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+bool BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator!=(const BasicMonomial& other) const
+{
+    return !(*this == other);
+}
+
+// region Arithmetic
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT> BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator-() const
+{
+    BasicMonomial res(*this);
+    res.k = -res.k;
+
+    return res;
+}
+
+//
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT> BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator+(const BasicMonomial &other) const
+{
+    return apply_sum(*this, other, std::plus{});
+}
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT>& BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator+=(const BasicMonomial& other)
+{
+    apply_sum_to(*this, other, std::plus{});
+    return *this;
+}
+
+//
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT> BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator-(const BasicMonomial &other) const
+{
+    return apply_sum(*this, other, std::minus{});
+}
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT>& BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator-=(const BasicMonomial& other)
+{
+    apply_sum_to(*this, other, std::minus{});
+    return *this;
+}
+
+//
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT> BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator*(const BasicMonomial &other) const
+{
+    return apply_mult(*this, other, std::multiplies{}, Degrees::add_to);
+}
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT>& BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator*=(const BasicMonomial& other)
+{
+    apply_mult_to(*this, other, std::multiplies{}, Degrees::add_to);
+    return *this;
+}
+
+//
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT> BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator/(const BasicMonomial &other) const
+{
+    return apply_mult(*this, other, std::divides{}, Degrees::subtract_from);
+}
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT>& BasicMonomial<NVars, DegreeT, Order, CoeffT>::operator/=(const BasicMonomial& other)
+{
+    apply_mult_to(*this, other, std::divides{}, Degrees::subtract_from);
+    return *this;
+}
+
+//
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+BasicMonomial<NVars, DegreeT, Order, CoeffT> BasicMonomial<NVars, DegreeT, Order, CoeffT>::pow(unsigned exponent) const
+{
+    BasicMonomial res(coeff_t(1));
+    BasicMonomial base(*this);
+    for (; exponent; exponent >>= 1) {
+        if (exponent & 1) {
+            res *= base;
+        }
+        if (exponent > 1) {
+            base *= base;
+        }
+    }
+    return res;
+}
+
+// endregion
+
+// region Arithmetic Helpers
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+template<typename Operation>
+BasicMonomial<NVars, DegreeT, Order, CoeffT> BasicMonomial<NVars, DegreeT, Order, CoeffT>::apply_sum(const BasicMonomial& m1, const BasicMonomial& m2, Operation op)
+{
+    if (m1.degs != m2.degs)
+        throw std::invalid_argument("Monomial degrees does not match");
+    BasicMonomial dst(m1);
+    apply_sum_to(dst, m2, op);
+    return dst;
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+template<typename Operation>
+void BasicMonomial<NVars, DegreeT, Order, CoeffT>::apply_sum_to(BasicMonomial& dst, const BasicMonomial& other, Operation op)
+{
+    if (dst.degs != other.degs)
+        throw std::invalid_argument("Monomial degrees does not match");
+    dst.k = op(dst.k, other.k);
+}
+
+//
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+template<typename OperationCoefficient, typename OperationDegree>
+BasicMonomial<NVars, DegreeT, Order, CoeffT> BasicMonomial<NVars, DegreeT, Order, CoeffT>::apply_mult(const BasicMonomial& m1, const BasicMonomial& m2,
+                                                                       OperationCoefficient opK, OperationDegree opDeg)
+{
+    BasicMonomial dst(m1);
+    apply_mult_to(dst, m2, opK, opDeg);
+    return dst;
+}
+
+template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+template<typename OperationCoefficient, typename OperationDegree>
+void BasicMonomial<NVars, DegreeT, Order, CoeffT>::apply_mult_to(BasicMonomial& dst, const BasicMonomial& other,
+                                                  OperationCoefficient opK, OperationDegree opDeg)
+{
+    if (!opDeg(dst.degs, other.degs)) {
+        throw std::runtime_error("Degree overflow");
+    }
+    dst.k = opK(dst.k, other.k);
+}
+
+// endregion
+
+namespace std {
+    template<size_t NVars, typename DegreeT, typename Order, typename CoeffT>
+    struct hash<BasicMonomial<NVars, DegreeT, Order, CoeffT>> {
+        size_t operator()(const BasicMonomial<NVars, DegreeT, Order, CoeffT>& m) const noexcept
+        {
+            return static_cast<size_t>(m.hash());
+        }
+    };
+}
+
+#endif // __MONOMIAL_H__
@@ -1,187 +1,309 @@
 #ifndef __POLYNOMIAL_H__
 #define __POLYNOMIAL_H__
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <future>
+#include <limits>
 #include <iostream>
+#include <map>
+#include <queue>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
-#include <limits>
+#include <vector>
 
-#include "ordered_linkedlist.h"
-#include "parsingexcept.h"
+#include "cow_vector.h"
+#include "evaluation_plan.h"
+#include "monomial.h"
+#include "transforms.h"
 
-class Monomial {
-private:
-    static const size_t COMPONENTS = 3;
+template<typename L, typename R>
+class PolynomialSum;
 
-    union Degrees {
-        typedef char value_t;
+//
+// Settings shared by all the polynomial types
+//
 
-        value_t values[COMPONENTS];
-        unsigned int packed;
+class PolynomialBase {
+public:
+    enum class MultiplicationStrategy {
+        Auto,
+        Heap,
+        Hash,
+        Kronecker
+    };
 
-        value_t& operator[](char var);
-        const value_t& operator[](char var) const;
+    // -- threads available to a single multiplication, defaults to the hardware concurrency.
+    //    There is no pool behind it: every multiplication large enough to be split starts
+    //    its worker threads anew and joins them before returning, the calling thread being
+    //    one of the workers, so a product taking less than a few thread starts should be
+    //    run with a single thread
+    [[nodiscard]] static size_t mult_threads() noexcept;
+    static void set_mult_threads(size_t threads) noexcept;
+};
 
-        bool operator==(const Degrees& other) const;
-        bool operator!=(const Degrees& other) const;
+template<typename MonomialT>
+class BasicPolynomial : public PolynomialBase {
+    template<typename, typename>
+    friend class PolynomialSum;
+public:
+    typedef MonomialT monomial_t;
+    typedef typename monomial_t::coeff_t coeff_t;
+private:
+    typedef typename monomial_t::coeff_traits coeff_traits;
 
-        bool operator<(const Degrees& other) const;
-        bool operator>(const Degrees& other) const;
-    };
+    static bool OrderFunction(const monomial_t& a, const monomial_t& b);
 
-    double k;
-    Degrees degs;
+    // -- kept sorted by OrderFunction, terms are stored contiguously
+    //    to avoid per-node allocations and pointer chasing on traversal,
+    //    copies of a polynomial share them until one of the copies is modified
+    CowVector<monomial_t> monomials;
 
-    template<class Reader>
-    void parse(Reader& reader);
+    // -- wrapping sum of the terms hashes, single term updates adjust it in O(1),
+    //    bulk changes leave it stale until the next read. Atomic, so that concurrent
+    //    reads of a shared polynomial may fill it, moved-from polynomials get it reset
+    struct HashCache {
+        std::atomic<uint64_t> sum{ 0 };
+        std::atomic<bool> valid{ false };
 
-    template<typename Operation>
-    static Monomial apply_sum(const Monomial& m1, const Monomial& m2, Operation op);
-    template<typename Operation>
-    static void apply_sum_to(Monomial& dst, const Monomial& other, Operation op);
-    //
-    template<typename OperationCoefficient, typename OperationDegree>
-    static Monomial apply_mult(const Monomial& m1, const Monomial& m2, OperationCoefficient opK, OperationDegree opDeg);
-    template<typename OperationCoefficient, typename OperationDegree>
-    static void apply_mult_to(Monomial& dst, const Monomial& other, OperationCoefficient opK, OperationDegree opDeg);
+        HashCache() = default;
+        HashCache(const HashCache& other) noexcept;
+        HashCache(HashCache&& other) noexcept;
+        HashCache& operator=(const HashCache& other) noexcept;
+        HashCache& operator=(HashCache&& other) noexcept;
+    };
+    mutable HashCache hash_cache;
 
-    Monomial(double k, Degrees degs);
-public:
-    static const char VAR_MAX = 'z';
-    static const char VAR_MIN = VAR_MAX - COMPONENTS + 1;
+    void invalidate_hash() noexcept;
+    // -- keeps a valid hash in sync with a single term replaced
+    void adjust_hash(const monomial_t* removed, const monomial_t* added) noexcept;
 
-    typedef std::unordered_map<char, double> Point;
+    // -- appends a monomial that does not precede the last one, skipping zeros
+    void append(const monomial_t& monomial);
+    void drop_zeros();
+    void negate() noexcept;
 
-    static const int DEGREE_MIN = std::numeric_limits<Degrees::value_t>::min();
-    static const int DEGREE_MAX = std::numeric_limits<Degrees::value_t>::max();
-    // static const int DEGREE_MAX = std::numeric_limits<decltype(*(static_cast<Degrees*>(nullptr)->values))>::max();
+    // -- dst += sign * k, without multiplying the coefficients
+    static void accumulate(coeff_t& dst, const coeff_t& k, int sign);
 
-    explicit Monomial(const std::string& raw);
-    explicit Monomial(const char* raw);
-    Monomial(double k, int degX, int degY, int degZ);
-    explicit Monomial(double k);
+    struct SumOperand {
+        const BasicPolynomial* polynomial;
+        int sign;
+        BasicPolynomial* owned; // -- set when the operand storage may be reused for the result
+    };
 
-    [[nodiscard]]
-    double coefficient() const noexcept;
-    void set_coefficient(double coefficient) noexcept;
+    static BasicPolynomial apply_sum(const BasicPolynomial& p1, const BasicPolynomial& p2, int sign);
+    // -- k-way merge of all the operands at once
+    static BasicPolynomial merge_sum(SumOperand* operands, size_t count);
+    static void apply_sum_to(BasicPolynomial& dst, const BasicPolynomial& other, int sign);
+    static void apply_mult_to(BasicPolynomial& dst, const monomial_t& monomial);
+    template<typename Operation>
+    static BasicPolynomial apply_mult(const BasicPolynomial& p1, const BasicPolynomial& p2, Operation op);
 
-    [[nodiscard]] bool cmp_degs(const Monomial& other) const noexcept;
-    [[nodiscard]] bool has_degs() const noexcept;
+    // -- points evaluated together by calculate_batch, so that the power tables of a block stay in cache
+    static constexpr size_t CALC_BATCH_BLOCK = 64;
 
-    Degrees::value_t& operator[](char var) noexcept;
-    const Degrees::value_t& operator[](char var) const noexcept;
+    // region Multiplication Engines
 
-    [[nodiscard]]
-    double calculate(const Point& point) const;
+    // -- hash accumulation pays off once the product is expected to have
+    //    fewer distinct terms than this fraction of all pairwise products
+    static constexpr size_t MULT_HASH_DENSITY = 8;
+    // -- Kronecker substitution is used once n * m exceeds L * log2(L) times this factor,
+    //    where L is the length of the univariate transform
+    static constexpr size_t MULT_KRONECKER_FACTOR = 8;
+    static constexpr size_t MULT_KRONECKER_MAX_LENGTH = size_t(1) << 26;
+    // -- FFT round-off is expected within bound * epsilon * log2(L) times this factor,
+    //    results below that are treated as zeros
+    static constexpr double MULT_FFT_ERROR_FACTOR = 64;
+    // -- least number of pairwise term products per worker thread
+    static constexpr size_t MULT_PARALLEL_GRAIN = size_t(1) << 16;
 
-    [[nodiscard]] Monomial differentiate(char variable) const;
-    [[nodiscard]] Monomial integrate(char variable) const;
+    struct DegreeBounds {
+        int lo[monomial_t::COMPONENTS];
+        int hi[monomial_t::COMPONENTS];
+    };
 
-    bool operator<(const Monomial& other) const;
-    bool operator>(const Monomial& other) const;
-    bool operator==(const Monomial& other) const;
-    bool operator!=(const Monomial& other) const;
+    [[nodiscard]] bool has_negative_degrees() const noexcept;
+    [[nodiscard]] bool has_integral_coefficients() const noexcept;
+    [[nodiscard]] DegreeBounds degree_bounds() const noexcept;
+    // -- upper bound of the product coefficients magnitude
+    static double coefficients_bound(const BasicPolynomial& p1, const BasicPolynomial& p2);
+    // -- least magnitude of a pairwise product of the coefficients
+    static double smallest_product(const BasicPolynomial& p1, const BasicPolynomial& p2);
+    // -- round-off the FFT convolution of the given length is expected to stay within
+    static double fft_error_bound(double bound, size_t length);
+    // -- upper bound of the product terms count, i.e. the volume of its degrees bounding box
+    static size_t estimate_product_size(const DegreeBounds& b1, const DegreeBounds& b2);
+    // -- transform length required to multiply by Kronecker substitution
+    static size_t kronecker_length(const DegreeBounds& b1, const DegreeBounds& b2);
 
-    Monomial operator-() const;
-    //
-    Monomial operator+(const Monomial& other) const;
-    Monomial& operator+=(const Monomial& other);
-    //
-    Monomial operator-(const Monomial& other) const;
-    Monomial& operator-=(const Monomial& other);
-    //
-    Monomial operator*(const Monomial& other) const;
-    Monomial& operator*=(const Monomial& other);
-    //
-    Monomial operator/(const Monomial& other) const;
-    Monomial& operator/=(const Monomial& other);
+    static MultiplicationStrategy choose_mult_strategy(const BasicPolynomial& p1, const BasicPolynomial& p2);
+    // -- runs the exact given strategy on the calling thread
+    static BasicPolynomial mult_serial(const BasicPolynomial& p1, const BasicPolynomial& p2, MultiplicationStrategy strategy);
+    // -- splits the longer operand between the threads and merges the partial products
+    static BasicPolynomial mult_parallel(const BasicPolynomial& p1, const BasicPolynomial& p2,
+                                         MultiplicationStrategy strategy, size_t threads);
 
-    friend std::ostream& operator<<(std::ostream& os, const Monomial& m)
-    {
-        if (m.degs.packed == 0 || fabs(m.k) != 1.0) {
-            os << m.k;
-        }
+    // -- k-way heap merge of the partial products, requires order to be preserved by multiplication
+    static BasicPolynomial mult_heap(const BasicPolynomial& p1, const BasicPolynomial& p2);
+    // -- accumulates coefficients in an open-addressing table and sorts the result once, works for any degrees
+    static BasicPolynomial mult_hash(const BasicPolynomial& p1, const BasicPolynomial& p2, size_t expected_size);
+    // -- the table behind mult_hash, products(add) should pass every term product to add
+    template<typename Products>
+    static BasicPolynomial accumulate_hash(size_t expected_size, Products products);
+    // -- maps both operands to univariate ones and convolves them with NTT (exact, integral coefficients) or FFT,
+    //    floating point coefficient types only
+    static BasicPolynomial mult_kronecker(const BasicPolynomial& p1, const BasicPolynomial& p2,
+                                          const DegreeBounds& b1, const DegreeBounds& b2);
 
-        Degrees::value_t deg;
-        for (char var = VAR_MIN; var <= VAR_MAX; var++)
-        {
-            deg = m.degs[var];
-            if (deg == 0)
-                continue;
+    // endregion
 
-            os << var;
-            if (deg != 1) {
-                os << "^" << static_cast<int>(deg);
-            }
-        }
+    // region Squaring
 
-        return os;
-    }
-};
+    // -- p * p over the pairs i <= j only, the cross products are doubled instead of computed twice
+    static BasicPolynomial square_heap(const BasicPolynomial& p);
+    static BasicPolynomial square_hash(const BasicPolynomial& p, size_t expected_size);
+    // -- binomial theorem, coefficients come from the Pascal's triangle row, so they are exact in any ring
+    static BasicPolynomial pow_binomial(const BasicPolynomial& p, unsigned exponent);
 
-class Polynomial {
-private:
-    static bool OrderFunction(const Monomial& a, const Monomial& b);
+    // endregion
+
+    struct Replacement {
+        char var;
+        const BasicPolynomial* polynomial;
+    };
 
-    OrderedLinkedList<Monomial> monomials = OrderedLinkedList<Monomial>(OrderFunction);
+    // -- the engine behind both substitute overloads
+    BasicPolynomial compose(const std::vector<Replacement>& replacements) const;
 
-    static Polynomial apply_sum(const Polynomial& p1, const Polynomial& p2, int sign);
-    template<typename Operation>
-    static Polynomial apply_mult(const Polynomial& p1, const Polynomial& p2, Operation op);
+    // -- dst[c - from] = d/dv_c for the variable slots c in [from, to), all in a single traversal
+    void partials_to(BasicPolynomial* dst, size_t from, size_t to) const;
 
 public:
+    // -- replacements of the variables, the absent ones are kept as they are
+    typedef std::unordered_map<char, BasicPolynomial> Substitution;
+    // -- partial derivatives by variable slot
+    typedef std::array<BasicPolynomial, monomial_t::COMPONENTS> Gradient;
+    typedef std::array<Gradient, monomial_t::COMPONENTS> Hessian;
 
-    Polynomial();
-    Polynomial(Monomial monomial);
-    explicit Polynomial(const std::string& raw);
+    BasicPolynomial();
+    BasicPolynomial(monomial_t monomial);
+    explicit BasicPolynomial(const std::string& raw);
 
-    void insert(const Monomial& monomial);
-    const Monomial& operator[](size_t idx) const;
+    // -- sum expressions are evaluated on conversion
+    template<typename L, typename R>
+    BasicPolynomial(PolynomialSum<L, R>&& sum);
+    template<typename L, typename R>
+    BasicPolynomial(const PolynomialSum<L, R>& sum);
+
+    // -- combines like terms, so no duplicate degrees are ever stored
+    void insert(const monomial_t& monomial);
+    const monomial_t& operator[](size_t idx) const;
     [[nodiscard]] size_t size() const;
 
+    // -- linear, a no-op for polynomials which are canonical already
     void compact();
 
     [[nodiscard]]
-    double calculate(const Monomial::Point& point) const;
+    double calculate(const typename monomial_t::Point& point) const;
+    [[nodiscard]]
+    double calculate(const typename monomial_t::FixedPoint& point) const noexcept;
+    // -- evaluates count points given as structure of arrays, coords[c][i] is the value of
+    //    the c-th variable at the i-th point, buffers of the absent variables may be null.
+    //    Powers come from per-block tables instead of pow(), and every loop runs over
+    //    a contiguous block of points, so it is left for the compiler to vectorize
+    void calculate_batch(const std::array<const double*, monomial_t::COMPONENTS>& coords, size_t count, double* out) const;
+    [[nodiscard]]
+    std::vector<double> calculate_batch(const std::array<std::vector<double>, monomial_t::COMPONENTS>& coords) const;
+    // -- nested Horner scheme, for evaluating the same polynomial at many points
+    [[nodiscard]] EvaluationPlan<monomial_t::COMPONENTS> compile() const;
+
+    [[nodiscard]] BasicPolynomial differentiate(char variable) const;
+    [[nodiscard]] BasicPolynomial integrate(char variable) const;
+    // -- all the partial derivatives from one pass over the terms
+    [[nodiscard]] Gradient gradient() const;
+    // -- derivatives of the gradient, only the upper triangle is computed and mirrored
+    [[nodiscard]] Hessian hessian() const;
+    // -- gradients of every polynomial, row by row
+    [[nodiscard]] static std::vector<Gradient> jacobian(const std::vector<BasicPolynomial>& polynomials);
+
+    // -- composition, every occurrence of the variable is replaced by q,
+    //    negative degrees of it are allowed only when q is a single term
+    [[nodiscard]] BasicPolynomial substitute(char variable, const BasicPolynomial& q) const;
+    // -- simultaneous, so the replacements may refer to any variables, {x: y, y: x} swaps them
+    [[nodiscard]] BasicPolynomial substitute(const Substitution& substitution) const;
+
+    [[nodiscard]]
+    BasicPolynomial multiply(const BasicPolynomial& other, MultiplicationStrategy strategy = MultiplicationStrategy::Auto) const;
+    // -- about half the term products of multiply(*this)
+    [[nodiscard]] BasicPolynomial square() const;
+    // -- square-and-multiply, single terms and binomials are raised in closed form
+    [[nodiscard]] BasicPolynomial pow(unsigned exponent) const;
+
+    // -- O(1) unless the polynomial was changed in bulk since the last call
+    [[nodiscard]] uint64_t hash() const noexcept;
 
-    [[nodiscard]] Polynomial differentiate(char variable) const;
-    [[nodiscard]] Polynomial integrate(char variable) const;
+    // -- sizes and hashes are compared first, the terms only when both match
+    bool operator==(const BasicPolynomial& other) const;
+    bool operator!=(const BasicPolynomial& other) const;
 
-    bool operator==(const Polynomial& other) const;
-    bool operator!=(const Polynomial& other) const;
+    // -- overloads taking an expiring operand reuse its storage for the result,
+    //    binary + and - produce PolynomialSum expressions (see below)
 
-    Polynomial operator-() const;
+    BasicPolynomial operator-() const&;
+    BasicPolynomial operator-() &&;
     //
-    Polynomial operator+(const Polynomial& other) const;
-    Polynomial& operator+=(const Polynomial& other);
+    BasicPolynomial& operator+=(const BasicPolynomial& other);
     //
-    Polynomial operator-(const Polynomial& other) const;
-    Polynomial& operator-=(const Polynomial& other);
+    BasicPolynomial& operator-=(const BasicPolynomial& other);
     //
-    Polynomial operator*(const Polynomial& other) const;
-    Polynomial& operator*=(const Polynomial& other);
+    BasicPolynomial operator*(const BasicPolynomial& other) const&;
+    BasicPolynomial operator*(const BasicPolynomial& other) &&;
+    BasicPolynomial operator*(BasicPolynomial&& other) const&;
+    BasicPolynomial operator*(BasicPolynomial&& other) &&;
+    BasicPolynomial& operator*=(const BasicPolynomial& other);
     //
-    Polynomial operator/(const Polynomial& other) const;
-    Polynomial& operator/=(const Polynomial& other);
+    // -- the quotient of divmod, with the remainder dropped, whatever the number of the divisor terms
+    BasicPolynomial operator/(const BasicPolynomial& other) const;
+    BasicPolynomial& operator/=(const BasicPolynomial& other);
+    // -- every term divided by the divisor, so the terms it does not divide get negative degrees
+    [[nodiscard]] BasicPolynomial divide_by_term(const monomial_t& divisor) const;
 
-    friend std::ostream& operator<<(std::ostream& os, const Polynomial& p)
+    struct DivisionResult {
+        std::vector<BasicPolynomial> quotients;
+        BasicPolynomial remainder;
+    };
+
+    // -- multivariate division in the polynomial order, *this = sum(quotients[i] * divisors[i]) + remainder,
+    //    where no remainder term is divisible by any divisor leading term, the earlier divisors take precedence.
+    //    Degrees should be non-negative, otherwise the order is not a well-order and the division might not stop
+    [[nodiscard]] DivisionResult divmod(const std::vector<BasicPolynomial>& divisors) const;
+    [[nodiscard]] std::pair<BasicPolynomial, BasicPolynomial> divmod(const BasicPolynomial& divisor) const;
+    [[nodiscard]] bool is_divisible_by(const BasicPolynomial& divisor) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const BasicPolynomial& p)
     {
-        double k, kAbs;
-        std::remove_reference<decltype(static_cast<Monomial*>(nullptr)->operator[](0))>::type deg;
+        typename monomial_t::Degrees::value_t deg;
         bool fst = true;
 
-        // for (auto it = p.monomials.cbegin(); it != p.monomials.cend(); ++it)
         for (const auto& m : std::as_const(p.monomials))
         {
-            k = m.coefficient();
-            kAbs = fabs(k);
+            const coeff_t& k = m.coefficient();
+            const bool negative = coeff_traits::is_negative(k);
+            const coeff_t kAbs = negative ? -k : k;
 
-            os << (fst ? "" : " ") << ((k < 0) ? "-" : (fst ? "" : "+")) << (fst ? "" : " ");
-            if (!m.has_degs() || kAbs != 1.0f) {
+            os << (fst ? "" : " ") << (negative ? "-" : (fst ? "" : "+")) << (fst ? "" : " ");
+            if (!m.has_degs() || kAbs != coeff_t(1)) {
                 os << kAbs;
             }
 
-            for (char var = Monomial::VAR_MIN; var <= Monomial::VAR_MAX; var++)
+            for (char var = monomial_t::VAR_MIN; var <= monomial_t::VAR_MAX; var++)
             {
                 deg = m[var];
                 if (deg == 0)
@@ -200,5 +322,1951 @@ public:
     }
 };
 
+using Polynomial = BasicPolynomial<Monomial>;
+
+template<typename MonomialT>
+bool BasicPolynomial<MonomialT>::OrderFunction(const monomial_t &a, const monomial_t &b)
+{
+    return a > b;
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT>::BasicPolynomial() = default;
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT>::BasicPolynomial(const monomial_t monomial)
+{
+    append(monomial);
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT>::BasicPolynomial(const std::string& raw)
+{
+    const size_t length = raw.length();
+
+    // move null-terminator temporarily for extra optimization
+    // and copying avoidance, using C-style strings
+    size_t marker;
+    char to_restore = 0;
+
+    bool has_unparsed_data = true;
+
+    for (size_t i = length; i-- > 0; ) {
+        if (raw[i] == '+' || raw[i] == '-') {
+            insert(monomial_t(&raw[i]));
+
+            if (to_restore != 0) {
+                const_cast<std::string&>(raw)[marker] = to_restore;
+            }
+            to_restore = raw[i];
+            const_cast<std::string&>(raw)[i] = 0;
+            marker = i;
+
+            has_unparsed_data = false;
+        } else if (raw[i] != ' ') {
+            has_unparsed_data = true;
+        }
+    }
+
+    if (has_unparsed_data) {
+        insert(monomial_t(&raw[0]));
+    }
+
+    if (to_restore != 0) {
+        const_cast<std::string&>(raw)[marker] = to_restore;
+    }
+}
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::insert(const monomial_t& monomial)
+{
+    if (coeff_traits::is_zero(monomial.coefficient()))
+        return;
+
+    // like terms get combined right away, so the storage stays canonical
+    const auto pos = std::lower_bound(monomials.begin(), monomials.end(), monomial, OrderFunction);
+    if (pos != monomials.end() && pos->cmp_degs(monomial)) {
+        const size_t idx = pos - monomials.begin();
+        auto& terms = monomials.mutate();
+        const monomial_t old = terms[idx];
+        terms[idx].k += monomial.k;
+        if (coeff_traits::is_zero(terms[idx].coefficient())) {
+            terms.erase(terms.begin() + idx);
+            adjust_hash(&old, nullptr);
+        } else {
+            adjust_hash(&old, &terms[idx]);
+        }
+        return;
+    }
+    adjust_hash(nullptr, &monomial);
+    monomials.insert(pos, monomial);
+}
+
+template<typename MonomialT>
+const MonomialT& BasicPolynomial<MonomialT>::operator[](size_t idx) const
+{
+    return monomials[idx];
+}
+
+template<typename MonomialT>
+size_t BasicPolynomial<MonomialT>::size() const
+{
+    return monomials.size();
+}
+
+//
+// Polynomials are kept canonical by every operation, but the storage
+// is sorted anyway, so like terms are adjacent and a single in-place pass
+// is enough to combine them and drop the cancelled ones
+//
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::compact()
+{
+    invalidate_hash();
+
+    auto& terms = monomials.mutate();
+    size_t out = 0;
+    for (size_t i = 0; i < terms.size(); ) {
+        monomial_t acc = terms[i++];
+        for (; i < terms.size() && terms[i].cmp_degs(acc); i++) {
+            acc.k += terms[i].k;
+        }
+        if (!coeff_traits::is_zero(acc.coefficient())) {
+            terms[out++] = acc;
+        }
+    }
+    terms.erase(terms.begin() + out, terms.end());
+}
+
+template<typename MonomialT>
+double BasicPolynomial<MonomialT>::calculate(const typename monomial_t::Point& point) const
+{
+    double res = .0;
+    for (const auto& m : monomials)
+    {
+        res += m.calculate(point);
+    }
+    return res;
+}
+
+template<typename MonomialT>
+double BasicPolynomial<MonomialT>::calculate(const typename monomial_t::FixedPoint& point) const noexcept
+{
+    double res = .0;
+    for (const auto& m : monomials)
+    {
+        res += m.calculate(point);
+    }
+    return res;
+}
+
+//
+// Points go by blocks: the powers of every variable over the degrees range
+// get tabulated for the whole block by repeated multiplication, then each term
+// is a product of the table rows, accumulated into the output row
+//
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::calculate_batch(const std::array<const double*, monomial_t::COMPONENTS>& coords,
+                                                 size_t count, double* out) const
+{
+    constexpr size_t N = monomial_t::COMPONENTS;
+    constexpr size_t BLOCK = CALC_BATCH_BLOCK;
+
+    std::fill(out, out + count, 0.0);
+    if (monomials.empty())
+        return;
+
+    const DegreeBounds bounds = degree_bounds();
+
+    // the table of a variable spans the degrees from min(lo, 0) to max(hi, 0)
+    int lo[N], hi[N];
+    size_t first_row[N];
+    size_t rows = 0;
+    for (size_t c = 0; c < N; c++) {
+        lo[c] = std::min(bounds.lo[c], 0);
+        hi[c] = std::max(bounds.hi[c], 0);
+        if ((lo[c] != 0 || hi[c] != 0) && !coords[c]) {
+            throw std::invalid_argument("Incomplete point, missing a component");
+        }
+        first_row[c] = rows;
+        rows += hi[c] - lo[c] + 1;
+    }
+
+    // terms are flattened once, as a coefficient and the table rows to multiply by
+    std::vector<double> ks;
+    std::vector<size_t> term_rows, term_ends;
+    ks.reserve(size());
+    term_ends.reserve(size());
+    for (const auto& m : monomials) {
+        ks.push_back(coeff_traits::to_double(m.k));
+        for (size_t c = 0; c < N; c++) {
+            const int deg = m.degs.get(c);
+            if (deg != 0) {
+                term_rows.push_back(first_row[c] + (deg - lo[c]));
+            }
+        }
+        term_ends.push_back(term_rows.size());
+    }
+
+    std::vector<double> table(rows * BLOCK);
+    double term[BLOCK];
+
+    for (size_t base = 0; base < count; base += BLOCK) {
+        const size_t n = std::min(BLOCK, count - base);
+
+        for (size_t c = 0; c < N; c++) {
+            if (lo[c] == hi[c])
+                continue;
+
+            const double* x = coords[c] + base;
+            double* zero = &table[(first_row[c] - lo[c]) * BLOCK];
+            std::fill(zero, zero + n, 1.0);
+
+            for (int d = 1; d <= hi[c]; d++) {
+                double* row = zero + d * static_cast<std::ptrdiff_t>(BLOCK);
+                const double* prev = row - BLOCK;
+                for (size_t i = 0; i < n; i++) {
+                    row[i] = prev[i] * x[i];
+                }
+            }
+            for (int d = -1; d >= lo[c]; d--) {
+                double* row = zero + d * static_cast<std::ptrdiff_t>(BLOCK);
+                const double* prev = row + BLOCK;
+                for (size_t i = 0; i < n; i++) {
+                    row[i] = prev[i] / x[i];
+                }
+            }
+        }
+
+        size_t r = 0;
+        for (size_t t = 0; t < ks.size(); t++) {
+            std::fill(term, term + n, ks[t]);
+            for (; r < term_ends[t]; r++) {
+                const double* row = &table[term_rows[r] * BLOCK];
+                for (size_t i = 0; i < n; i++) {
+                    term[i] *= row[i];
+                }
+            }
+
+            double* dst = out + base;
+            for (size_t i = 0; i < n; i++) {
+                dst[i] += term[i];
+            }
+        }
+    }
+}
+
+template<typename MonomialT>
+std::vector<double> BasicPolynomial<MonomialT>::calculate_batch(const std::array<std::vector<double>, monomial_t::COMPONENTS>& coords) const
+{
+    std::array<const double*, monomial_t::COMPONENTS> buffers;
+    size_t count = 0;
+    bool sized = false;
+
+    for (size_t c = 0; c < monomial_t::COMPONENTS; c++) {
+        if (coords[c].empty()) {
+            buffers[c] = nullptr;
+            continue;
+        }
+        if (sized && coords[c].size() != count) {
+            throw std::invalid_argument("Point buffers should be of the same length");
+        }
+        count = coords[c].size();
+        sized = true;
+        buffers[c] = coords[c].data();
+    }
+
+    std::vector<double> res(count);
+    calculate_batch(buffers, count, res.data());
+    return res;
+}
+
+template<typename MonomialT>
+EvaluationPlan<MonomialT::COMPONENTS> BasicPolynomial<MonomialT>::compile() const
+{
+    typename EvaluationPlan<monomial_t::COMPONENTS>::terms_t terms;
+    terms.reserve(size());
+
+    for (const auto& m : monomials) {
+        std::array<int, monomial_t::COMPONENTS> degs;
+        for (size_t c = 0; c < monomial_t::COMPONENTS; c++) {
+            degs[c] = m.degs.get(c);
+        }
+        terms.emplace_back(degs, coeff_traits::to_double(m.k));
+    }
+
+    return EvaluationPlan<monomial_t::COMPONENTS>(std::move(terms));
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::differentiate(char var) const
+{
+    if (var < monomial_t::VAR_MIN || var > monomial_t::VAR_MAX) {
+        throw std::invalid_argument("Non-existent variable");
+    }
+
+    const size_t c = var - monomial_t::VAR_MIN;
+    BasicPolynomial res;
+    partials_to(&res, c, c + 1);
+    return res;
+}
+
+template<typename MonomialT>
+typename BasicPolynomial<MonomialT>::Gradient BasicPolynomial<MonomialT>::gradient() const
+{
+    Gradient res;
+    partials_to(res.data(), 0, monomial_t::COMPONENTS);
+    return res;
+}
+
+template<typename MonomialT>
+typename BasicPolynomial<MonomialT>::Hessian BasicPolynomial<MonomialT>::hessian() const
+{
+    const Gradient g = gradient();
+
+    Hessian res;
+    for (size_t i = 0; i < monomial_t::COMPONENTS; i++) {
+        g[i].partials_to(&res[i][i], i, monomial_t::COMPONENTS);
+        for (size_t j = i + 1; j < monomial_t::COMPONENTS; j++) {
+            res[j][i] = res[i][j];
+        }
+    }
+    return res;
+}
+
+template<typename MonomialT>
+std::vector<typename BasicPolynomial<MonomialT>::Gradient> BasicPolynomial<MonomialT>::jacobian(const std::vector<BasicPolynomial>& polynomials)
+{
+    std::vector<Gradient> res(polynomials.size());
+    for (size_t i = 0; i < polynomials.size(); i++) {
+        polynomials[i].partials_to(res[i].data(), 0, monomial_t::COMPONENTS);
+    }
+    return res;
+}
+
+//
+// Differentiation lowers the same degree of every term it keeps, which preserves
+// the order of non-negative degrees, so the results are appended as they come.
+// Packed negative degrees may borrow from the neighbouring ones, those get sorted once
+//
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::partials_to(BasicPolynomial* dst, size_t from, size_t to) const
+{
+    const bool ordered = !has_negative_degrees();
+
+    for (size_t c = from; c < to; c++) {
+        dst[c - from].monomials.clear();
+        dst[c - from].monomials.reserve(monomials.size());
+    }
+
+    for (const auto& m : monomials) {
+        for (size_t c = from; c < to; c++) {
+            const char var = static_cast<char>(monomial_t::VAR_MIN + c);
+            if (m[var] == 0)
+                continue;
+
+            BasicPolynomial& res = dst[c - from];
+            if (ordered) {
+                res.append(m.differentiate(var));
+            } else {
+                res.monomials.push_back(m.differentiate(var));
+            }
+        }
+    }
+
+    if (!ordered) {
+        for (size_t c = from; c < to; c++) {
+            dst[c - from].drop_zeros();
+            auto& terms = dst[c - from].monomials.mutate();
+            std::sort(terms.begin(), terms.end(), OrderFunction);
+        }
+    }
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::integrate(char var) const
+{
+    BasicPolynomial res;
+    for (const auto& item : monomials) {
+        res.insert(item.integrate(var));
+    }
+    return res;
+}
+
+template<typename MonomialT>
+uint64_t BasicPolynomial<MonomialT>::hash() const noexcept
+{
+    if (!hash_cache.valid.load(std::memory_order_acquire)) {
+        uint64_t sum = 0;
+        for (const auto& m : monomials) {
+            sum += m.hash();
+        }
+        hash_cache.sum.store(sum, std::memory_order_relaxed);
+        hash_cache.valid.store(true, std::memory_order_release);
+    }
+    return Hashing::combine(monomials.size(), hash_cache.sum.load(std::memory_order_relaxed));
+}
+
+template<typename MonomialT>
+bool BasicPolynomial<MonomialT>::operator==(const BasicPolynomial& other) const
+{
+    if (monomials.size() != other.monomials.size() || hash() != other.hash())
+        return false;
+    return monomials == other.monomials;
+}
+
+template<typename MonomialT>
+bool BasicPolynomial<MonomialT>::operator!=(const BasicPolynomial& other) const
+{
+    return !(*this == other);
+}
+
+// region Arithmetic
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::operator-() const&
+{
+    BasicPolynomial res(*this); // negation keeps the order, so no need to insert element-by-element
+    res.negate();
+    return res;
+}
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::operator-() &&
+{
+    negate();
+    return std::move(*this);
+}
+
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT>& BasicPolynomial<MonomialT>::operator+=(const BasicPolynomial& other)
+{
+    apply_sum_to(*this, other, 1);
+    return *this;
+}
+
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT>& BasicPolynomial<MonomialT>::operator-=(const BasicPolynomial& other)
+{
+    apply_sum_to(*this, other, -1);
+    return *this;
+}
+
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::operator*(const BasicPolynomial& other) const&
+{
+    return multiply(other);
+}
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::operator*(const BasicPolynomial& other) &&
+{
+    *this *= other;
+    return std::move(*this);
+}
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::operator*(BasicPolynomial&& other) const&
+{
+    other *= *this;
+    return std::move(other);
+}
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::operator*(BasicPolynomial&& other) &&
+{
+    *this *= other;
+    return std::move(*this);
+}
+template<typename MonomialT>
+BasicPolynomial<MonomialT>& BasicPolynomial<MonomialT>::operator*=(const BasicPolynomial& other)
+{
+    if (other.size() == 1) {
+        apply_mult_to(*this, other.monomials.front());
+    } else {
+        *this = multiply(other);
+    }
+    return *this;
+}
+
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::operator/(const BasicPolynomial& other) const
+{
+    return divmod(other).first;
+}
+template<typename MonomialT>
+BasicPolynomial<MonomialT>& BasicPolynomial<MonomialT>::operator/=(const BasicPolynomial& other)
+{
+    *this = *this / other;
+    return *this;
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::divide_by_term(const monomial_t& divisor) const
+{
+    return apply_mult(*this, BasicPolynomial(divisor), std::divides{});
+}
+
+// endregion
+
+// region Division
+
+//
+// Heap division: the running dividend f - sum(q * g) is never stored, it is merged
+// lazily from the streams instead, one walking f and one per quotient term q walking
+// -q * (g - lt(g)). Every step pops the largest degrees of the streams, and either
+// divides them by the first divisor leading term that fits, or moves them to the remainder.
+// Multiplication by a term keeps the streams ordered, hence the non-negative degrees
+//
+
+template<typename MonomialT>
+typename BasicPolynomial<MonomialT>::DivisionResult BasicPolynomial<MonomialT>::divmod(const std::vector<BasicPolynomial>& divisors) const
+{
+    for (const auto& g : divisors) {
+        if (g.monomials.empty())
+            throw std::domain_error("Division by zero");
+        if (g.has_negative_degrees())
+            throw std::invalid_argument("Division requires non-negative degrees");
+    }
+    if (has_negative_degrees()) {
+        throw std::invalid_argument("Division requires non-negative degrees");
+    }
+
+    DivisionResult res;
+    res.quotients.resize(divisors.size());
+
+    struct Stream {
+        const BasicPolynomial* polynomial;
+        monomial_t factor; // -- negated quotient term, the unit one for the dividend
+    };
+    struct Entry {
+        monomial_t head;
+        size_t stream, j;
+    };
+    const auto cmp = [](const Entry& a, const Entry& b) {
+        return OrderFunction(b.head, a.head);
+    };
+
+    std::vector<Stream> streams;
+    std::priority_queue<Entry, std::vector<Entry>, decltype(cmp)> heap(cmp);
+
+    streams.push_back({ this, monomial_t(coeff_t(1)) });
+    if (!monomials.empty()) {
+        heap.push({ monomials[0], 0, 0 });
+    }
+
+    const auto advance = [&](Entry& e) {
+        const Stream& s = streams[e.stream];
+        const auto& terms = s.polynomial->monomials.view();
+        if (++e.j < terms.size()) {
+            e.head = s.factor * terms[e.j];
+            heap.push(e);
+        }
+    };
+
+    while (!heap.empty())
+    {
+        monomial_t lead = heap.top().head;
+        lead.k = coeff_t(0);
+        while (!heap.empty() && heap.top().head.cmp_degs(lead)) {
+            Entry e = heap.top();
+            heap.pop();
+            lead.k += e.head.k;
+            advance(e);
+        }
+
+        if (coeff_traits::is_zero(lead.k))
+            continue;
+
+        size_t i = 0;
+        while (i < divisors.size() && !divisors[i].monomials[0].divides(lead)) {
+            i++;
+        }
+
+        if (i == divisors.size()) {
+            res.remainder.append(lead);
+            continue;
+        }
+
+        const BasicPolynomial& g = divisors[i];
+        const monomial_t term = lead / g.monomials[0];
+        res.quotients[i].append(term);
+
+        // the leading term is cancelled already, the rest of the divisor streams from the second one
+        if (g.size() > 1) {
+            streams.push_back({ &g, -term });
+            heap.push({ streams.back().factor * g.monomials[1], streams.size() - 1, 1 });
+        }
+    }
+
+    return res;
+}
+
+template<typename MonomialT>
+std::pair<BasicPolynomial<MonomialT>, BasicPolynomial<MonomialT>> BasicPolynomial<MonomialT>::divmod(const BasicPolynomial& divisor) const
+{
+    DivisionResult res = divmod(std::vector<BasicPolynomial>{ divisor });
+    return { std::move(res.quotients[0]), std::move(res.remainder) };
+}
+
+template<typename MonomialT>
+bool BasicPolynomial<MonomialT>::is_divisible_by(const BasicPolynomial& divisor) const
+{
+    return divmod(divisor).second.monomials.empty();
+}
+
+// endregion
+
+// region Hashing
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT>::HashCache::HashCache(const HashCache& other) noexcept
+{
+    *this = other;
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT>::HashCache::HashCache(HashCache&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+template<typename MonomialT>
+typename BasicPolynomial<MonomialT>::HashCache& BasicPolynomial<MonomialT>::HashCache::operator=(const HashCache& other) noexcept
+{
+    sum.store(other.sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    valid.store(other.valid.load(std::memory_order_acquire), std::memory_order_release);
+    return *this;
+}
+
+template<typename MonomialT>
+typename BasicPolynomial<MonomialT>::HashCache& BasicPolynomial<MonomialT>::HashCache::operator=(HashCache&& other) noexcept
+{
+    *this = other;
+    other.valid.store(false, std::memory_order_relaxed);
+    return *this;
+}
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::invalidate_hash() noexcept
+{
+    hash_cache.valid.store(false, std::memory_order_relaxed);
+}
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::adjust_hash(const monomial_t* removed, const monomial_t* added) noexcept
+{
+    if (!hash_cache.valid.load(std::memory_order_relaxed))
+        return;
+
+    uint64_t sum = hash_cache.sum.load(std::memory_order_relaxed);
+    if (removed) {
+        sum -= removed->hash();
+    }
+    if (added) {
+        sum += added->hash();
+    }
+    hash_cache.sum.store(sum, std::memory_order_relaxed);
+}
+
+// endregion
+
+// region Arithmetic Helpers
+
+//
+// We will use the fact that monomial list is sorted
+// for matching monomials search optimization
+//
+
+//
+// Both operands are already ordered, so the result is produced
+// in order as well and can be appended without any lookups
+//
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::append(const monomial_t& monomial)
+{
+    if (coeff_traits::is_zero(monomial.coefficient()))
+        return;
+
+    assert((monomials.empty() || !OrderFunction(monomial, monomials.back())) && "monomial_t breaks the order");
+    monomials.push_back(monomial);
+}
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::negate() noexcept
+{
+    invalidate_hash();
+    for (auto& m : monomials.mutate()) {
+        m.k = -m.k;
+    }
+}
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::drop_zeros()
+{
+    invalidate_hash();
+    auto& terms = monomials.mutate();
+    terms.erase(std::remove_if(terms.begin(), terms.end(), [](const monomial_t& m) {
+        return coeff_traits::is_zero(m.coefficient());
+    }), terms.end());
+}
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::accumulate(coeff_t& dst, const coeff_t& k, int sign)
+{
+    if (sign < 0) {
+        dst -= k;
+    } else {
+        dst += k;
+    }
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::apply_sum(const BasicPolynomial& p1, const BasicPolynomial& p2, int sign)
+{
+    BasicPolynomial dst;
+    dst.monomials.reserve(p1.size() + p2.size());
+
+    auto it1 = p1.monomials.cbegin(), end1 = p1.monomials.cend();
+    auto it2 = p2.monomials.cbegin(), end2 = p2.monomials.cend();
+
+    monomial_t buf(coeff_t(0));
+    while (it1 != end1 && it2 != end2) {
+        if (OrderFunction(*it1, *it2)) {
+            dst.append(*it1++);
+        } else if (OrderFunction(*it2, *it1)) {
+            buf = *it2++;
+            if (sign < 0) {
+                buf.k = -buf.k;
+            }
+            dst.append(buf);
+        } else {
+            buf = *it1++;
+            accumulate(buf.k, (it2++)->k, sign);
+            dst.append(buf);
+        }
+    }
+
+    for (; it1 != end1; ++it1) {
+        dst.append(*it1);
+    }
+    for (; it2 != end2; ++it2) {
+        buf = *it2;
+        if (sign < 0) {
+            buf.k = -buf.k;
+        }
+        dst.append(buf);
+    }
+
+    return dst;
+}
+
+//
+// Every step picks the leading term among the operands heads and
+// accumulates it from all of them, operand count is a compile-time
+// constant of the expression, so a linear scan over the heads is enough
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::merge_sum(SumOperand* operands, size_t count)
+{
+    // a single in-place merge is cheaper whenever there is a storage to reuse
+    if (count == 2) {
+        SumOperand& a = operands[0];
+        SumOperand& b = operands[1];
+
+        SumOperand* dst = (a.owned && (!b.owned || a.polynomial->size() >= b.polynomial->size())) ? &a
+                : (b.owned ? &b : nullptr);
+        if (dst) {
+            const SumOperand& src = (dst == &a) ? b : a;
+
+            BasicPolynomial res(std::move(*dst->owned));
+            if (dst->sign < 0) {
+                res.negate();
+            }
+            apply_sum_to(res, *src.polynomial, src.sign);
+            return res;
+        }
+    }
+
+    size_t total = 0;
+    std::vector<size_t> pos(count, 0);
+    for (size_t i = 0; i < count; i++) {
+        total += operands[i].polynomial->size();
+    }
+
+    BasicPolynomial dst;
+    dst.monomials.reserve(total);
+
+    while (true)
+    {
+        const monomial_t* lead = nullptr;
+        for (size_t i = 0; i < count; i++) {
+            const auto& terms = operands[i].polynomial->monomials.view();
+            if (pos[i] < terms.size() && (!lead || OrderFunction(terms[pos[i]], *lead))) {
+                lead = &terms[pos[i]];
+            }
+        }
+        if (!lead)
+            break;
+
+        monomial_t acc = *lead;
+        acc.k = coeff_t(0);
+        for (size_t i = 0; i < count; i++) {
+            const auto& terms = operands[i].polynomial->monomials.view();
+            for (; pos[i] < terms.size() && terms[pos[i]].cmp_degs(acc); pos[i]++) {
+                accumulate(acc.k, terms[pos[i]].k, operands[i].sign);
+            }
+        }
+        dst.append(acc);
+    }
+
+    return dst;
+}
+
+//
+// In-place sum first updates the terms that are already present,
+// so when the terms set does not change nothing gets reallocated,
+// otherwise the storage is grown once and merged from the back
+//
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::apply_sum_to(BasicPolynomial& dst, const BasicPolynomial& other, int sign)
+{
+    dst.invalidate_hash();
+
+    if (&dst == &other) {
+        if (sign < 0) {
+            dst.monomials.clear();
+            return;
+        }
+        for (auto& m : dst.monomials.mutate()) {
+            m.k += m.k;
+        }
+        dst.drop_zeros();
+        return;
+    }
+
+    auto& terms = dst.monomials.mutate();
+    const size_t n = terms.size();
+
+    size_t missing = 0;
+    auto it = terms.begin();
+    for (const auto& m : other.monomials) {
+        while (it != terms.end() && OrderFunction(*it, m)) {
+            ++it;
+        }
+        if (it != terms.end() && it->cmp_degs(m)) {
+            accumulate(it->k, m.k, sign);
+        } else {
+            missing++;
+        }
+    }
+
+    if (missing != 0) {
+        terms.resize(n + missing, monomial_t(coeff_t(0)));
+
+        const auto& others = other.monomials.view();
+        size_t i = n, j = others.size(), w = n + missing;
+        while (j > 0) {
+            const monomial_t& m = others[j - 1];
+            if (i > 0 && OrderFunction(m, terms[i - 1])) {
+                terms[--w] = terms[--i];
+            } else if (i > 0 && terms[i - 1].cmp_degs(m)) {
+                j--; // already accumulated
+            } else {
+                terms[--w] = m;
+                if (sign < 0) {
+                    terms[w].k = -terms[w].k;
+                }
+                j--;
+            }
+        }
+    }
+
+    dst.drop_zeros();
+}
+
+template<typename MonomialT>
+void BasicPolynomial<MonomialT>::apply_mult_to(BasicPolynomial& dst, const monomial_t& monomial)
+{
+    dst.invalidate_hash();
+
+    //
+    // Multiplication by a single term keeps the order as long as the packed
+    // degrees do not wrap, the bounds are checked upfront so that the overflow
+    // can not leave the polynomial half-multiplied
+    //
+    const DegreeBounds bounds = dst.degree_bounds();
+    for (size_t c = 0; c < monomial_t::COMPONENTS; c++) {
+        if (bounds.hi[c] + monomial.degs.get(c) > monomial_t::DEGREE_MAX) {
+            throw std::runtime_error("Degree overflow");
+        }
+    }
+    bool negative = false;
+    for (size_t c = 0; c < monomial_t::COMPONENTS; c++) {
+        negative |= monomial.degs.get(c) < 0;
+    }
+    if (negative || dst.has_negative_degrees()) {
+        dst = dst.multiply(BasicPolynomial(monomial));
+        return;
+    }
+
+    for (auto& m : dst.monomials.mutate()) {
+        m *= monomial;
+    }
+    dst.drop_zeros();
+}
+
+template<typename MonomialT>
+template<typename Operation>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::apply_mult(const BasicPolynomial& p1, const BasicPolynomial& p2, Operation op)
+{
+    BasicPolynomial dst;
+
+    for (const auto& m1 : p1.monomials) {
+        for (const auto& m2 : p2.monomials) {
+            dst.insert(op(m1, m2));
+        }
+    }
+
+    return dst;
+}
+
+// endregion
+
+template<typename MonomialT>
+bool BasicPolynomial<MonomialT>::has_negative_degrees() const noexcept
+{
+    return std::any_of(monomials.cbegin(), monomials.cend(), [](const monomial_t& m) {
+        for (char var = monomial_t::VAR_MIN; var <= monomial_t::VAR_MAX; var++) {
+            if (m[var] < 0)
+                return true;
+        }
+        return false;
+    });
+}
+
+template<typename MonomialT>
+typename BasicPolynomial<MonomialT>::DegreeBounds BasicPolynomial<MonomialT>::degree_bounds() const noexcept
+{
+    DegreeBounds bounds;
+    std::fill(std::begin(bounds.lo), std::end(bounds.lo), monomial_t::DEGREE_MAX);
+    std::fill(std::begin(bounds.hi), std::end(bounds.hi), monomial_t::DEGREE_MIN);
+
+    for (const auto& m : monomials) {
+        for (size_t c = 0; c < monomial_t::COMPONENTS; c++) {
+            bounds.lo[c] = std::min<int>(bounds.lo[c], m.degs.get(c));
+            bounds.hi[c] = std::max<int>(bounds.hi[c], m.degs.get(c));
+        }
+    }
+
+    return bounds;
+}
+
+template<typename MonomialT>
+bool BasicPolynomial<MonomialT>::has_integral_coefficients() const noexcept
+{
+    return std::all_of(monomials.cbegin(), monomials.cend(), [](const monomial_t& m) {
+        return std::trunc(m.k) == m.k;
+    });
+}
+
+template<typename MonomialT>
+double BasicPolynomial<MonomialT>::coefficients_bound(const BasicPolynomial& p1, const BasicPolynomial& p2)
+{
+    double max1 = 0, max2 = 0;
+    for (const auto& m : p1.monomials) {
+        max1 = std::max(max1, fabs(m.k));
+    }
+    for (const auto& m : p2.monomials) {
+        max2 = std::max(max2, fabs(m.k));
+    }
+
+    // any product coefficient is a sum of at most min(n, m) pairwise products
+    return max1 * max2 * static_cast<double>(std::min(p1.size(), p2.size()));
+}
+
+template<typename MonomialT>
+double BasicPolynomial<MonomialT>::smallest_product(const BasicPolynomial& p1, const BasicPolynomial& p2)
+{
+    double min1 = std::numeric_limits<double>::infinity(), min2 = min1;
+    for (const auto& m : p1.monomials) {
+        min1 = std::min(min1, fabs(m.k));
+    }
+    for (const auto& m : p2.monomials) {
+        min2 = std::min(min2, fabs(m.k));
+    }
+    return min1 * min2;
+}
+
+template<typename MonomialT>
+double BasicPolynomial<MonomialT>::fft_error_bound(double bound, size_t length)
+{
+    const double log_length = std::max(std::log2(static_cast<double>(length)), 1.0);
+    return bound * std::numeric_limits<double>::epsilon() * log_length * MULT_FFT_ERROR_FACTOR;
+}
+
+template<typename MonomialT>
+size_t BasicPolynomial<MonomialT>::estimate_product_size(const DegreeBounds& b1, const DegreeBounds& b2)
+{
+    // saturates, as the box spanning many variables easily exceeds any size
+    size_t volume = 1;
+    for (size_t c = 0; c < monomial_t::COMPONENTS; c++) {
+        const size_t span = (b1.hi[c] + b2.hi[c]) - (b1.lo[c] + b2.lo[c]) + 1;
+        if (volume > std::numeric_limits<size_t>::max() / span) {
+            return std::numeric_limits<size_t>::max();
+        }
+        volume *= span;
+    }
+    return volume;
+}
+
+template<typename MonomialT>
+size_t BasicPolynomial<MonomialT>::kronecker_length(const DegreeBounds& b1, const DegreeBounds& b2)
+{
+    const size_t volume = estimate_product_size(b1, b2);
+
+    size_t length = 1;
+    while (length < volume) {
+        if (length > std::numeric_limits<size_t>::max() / 2) {
+            return std::numeric_limits<size_t>::max();
+        }
+        length <<= 1;
+    }
+    return length;
+}
+
+template<typename MonomialT>
+PolynomialBase::MultiplicationStrategy BasicPolynomial<MonomialT>::choose_mult_strategy(const BasicPolynomial& p1, const BasicPolynomial& p2)
+{
+    const size_t pairs = p1.size() * p2.size();
+    const DegreeBounds b1 = p1.degree_bounds(), b2 = p2.degree_bounds();
+
+    if constexpr (coeff_traits::APPROXIMATE) {
+        const size_t length = kronecker_length(b1, b2);
+        size_t log_length = 0;
+        while ((size_t(1) << log_length) < length) {
+            log_length++;
+        }
+
+        if (length <= MULT_KRONECKER_MAX_LENGTH
+                && length * std::max<size_t>(log_length, 1) * MULT_KRONECKER_FACTOR <= pairs) {
+            // integral coefficients are expected to be multiplied exactly, and the fractional ones
+            // should not lose any term to the round-off, which the heap would have kept
+            const double bound = coefficients_bound(p1, p2);
+            const bool lossless = (p1.has_integral_coefficients() && p2.has_integral_coefficients())
+                    ? length <= Transforms::NTT_MAX_LENGTH && Transforms::ntt_primes_required(bound) > 0
+                    : smallest_product(p1, p2) > fft_error_bound(bound, length);
+            if (lossless) {
+                return MultiplicationStrategy::Kronecker;
+            }
+        }
+    }
+    // the volume saturates at the largest size, so it is the pairs count that gets divided
+    if (estimate_product_size(b1, b2) <= pairs / MULT_HASH_DENSITY) {
+        return MultiplicationStrategy::Hash;
+    }
+    return MultiplicationStrategy::Heap;
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::multiply(const BasicPolynomial& other, MultiplicationStrategy strategy) const
+{
+    if (monomials.empty() || other.monomials.empty()) {
+        return {};
+    }
+
+    if (strategy == MultiplicationStrategy::Auto) {
+        strategy = choose_mult_strategy(*this, other);
+    }
+
+    // transform costs do not shrink with the operand, so splitting it makes no sense
+    if (strategy != MultiplicationStrategy::Kronecker) {
+        const size_t threads = std::min({
+            mult_threads(),
+            (size() * other.size()) / MULT_PARALLEL_GRAIN,
+            std::max(size(), other.size())
+        });
+        if (threads > 1) {
+            return mult_parallel(*this, other, strategy, threads);
+        }
+    }
+
+    return mult_serial(*this, other, strategy);
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::mult_serial(const BasicPolynomial& p1, const BasicPolynomial& p2, MultiplicationStrategy strategy)
+{
+    //
+    // Degrees are compared as packed unsigned words, so the order survives
+    // multiplication only while no component borrows from its neighbour,
+    // which is guaranteed for non-negative degrees (overflow throws anyway)
+    //
+    if (strategy == MultiplicationStrategy::Heap
+            && (p1.has_negative_degrees() || p2.has_negative_degrees())) {
+        strategy = MultiplicationStrategy::Hash;
+    }
+
+    const DegreeBounds b1 = p1.degree_bounds(), b2 = p2.degree_bounds();
+
+    // the substitution of too many sparse variables does not fit any transform,
+    // and the exact coefficient types can not go through the floating point ones at all
+    if (strategy == MultiplicationStrategy::Kronecker) {
+        if constexpr (coeff_traits::APPROXIMATE) {
+            if (kronecker_length(b1, b2) <= MULT_KRONECKER_MAX_LENGTH) {
+                return mult_kronecker(p1, p2, b1, b2);
+            }
+        }
+        strategy = MultiplicationStrategy::Hash;
+    }
+
+    switch (strategy) {
+        case MultiplicationStrategy::Hash:
+            return mult_hash(p1, p2, std::min(estimate_product_size(b1, b2), p1.size() * p2.size()));
+        default:
+            return mult_heap(p1, p2);
+    }
+}
+
+//
+// Johnson's algorithm: every term of the shorter operand f owns a stream
+// f[i] * g[0], f[i] * g[1], ... which is already ordered, so the heap
+// holding the head of each stream yields the product terms in order
+// and equal degrees come out adjacent to be combined on the fly
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::mult_heap(const BasicPolynomial& p1, const BasicPolynomial& p2)
+{
+    const BasicPolynomial& f = (p1.size() <= p2.size()) ? p1 : p2;
+    const BasicPolynomial& g = (p1.size() <= p2.size()) ? p2 : p1;
+
+    struct Stream {
+        monomial_t head;
+        size_t i, j;
+    };
+    const auto cmp = [](const Stream& a, const Stream& b) {
+        return OrderFunction(b.head, a.head);
+    };
+
+    const auto& fs = f.monomials.view();
+    const auto& gs = g.monomials.view();
+
+    std::vector<Stream> buf;
+    buf.reserve(fs.size());
+    for (size_t i = 0; i < fs.size(); i++) {
+        buf.push_back({ fs[i] * gs[0], i, 0 });
+    }
+    std::priority_queue<Stream, std::vector<Stream>, decltype(cmp)> heap(cmp, std::move(buf));
+
+    BasicPolynomial dst;
+
+    monomial_t acc(coeff_t(0)); // zero accumulator is never appended
+    while (!heap.empty())
+    {
+        Stream s = heap.top();
+        heap.pop();
+
+        if (acc.cmp_degs(s.head)) {
+            acc += s.head;
+        } else {
+            dst.append(acc);
+            acc = s.head;
+        }
+
+        if (++s.j < gs.size()) {
+            s.head = fs[s.i] * gs[s.j];
+            heap.push(s);
+        }
+    }
+    dst.append(acc);
+
+    return dst;
+}
+
+//
+// Linear probing over a power of two capacity, the table is sized after
+// the expected terms count (which is an upper bound), so it never grows
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::mult_hash(const BasicPolynomial& p1, const BasicPolynomial& p2, size_t expected_size)
+{
+    return accumulate_hash(expected_size, [&p1, &p2](auto add) {
+        for (const auto& m1 : p1.monomials) {
+            for (const auto& m2 : p2.monomials) {
+                add(m1 * m2);
+            }
+        }
+    });
+}
+
+template<typename MonomialT>
+template<typename Products>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::accumulate_hash(size_t expected_size, Products products)
+{
+    size_t capacity = 16;
+    unsigned int shift = 64 - 4;
+    while (capacity < 2 * expected_size) {
+        capacity <<= 1;
+        shift--;
+    }
+    const size_t mask = capacity - 1;
+
+    std::vector<std::pair<bool, monomial_t>> mem(capacity, { false, monomial_t(coeff_t(0)) });
+    size_t records = 0;
+
+    products([&](const monomial_t& m) {
+        size_t idx = static_cast<size_t>(m.degs.hash() >> shift);
+        while (mem[idx].first && !mem[idx].second.cmp_degs(m)) {
+            idx = (idx + 1) & mask;
+        }
+
+        if (mem[idx].first) {
+            mem[idx].second += m;
+        } else {
+            mem[idx] = { true, m };
+            records++;
+        }
+    });
+
+    BasicPolynomial dst;
+    dst.monomials.reserve(records);
+    for (const auto& row : mem) {
+        if (row.first && !coeff_traits::is_zero(row.second.coefficient())) {
+            dst.monomials.push_back(row.second);
+        }
+    }
+    auto& terms = dst.monomials.mutate();
+    std::sort(terms.begin(), terms.end(), OrderFunction);
+
+    return dst;
+}
+
+//
+// Kronecker substitution: x^a y^b z^c -> t^(a * Sy * Sz + b * Sz + c), where S are
+// the spans of the product degrees, so no carries between the components can happen.
+// Degrees are offset by the operands lower bounds, hence negative ones are fine too
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::mult_kronecker(const BasicPolynomial& p1, const BasicPolynomial& p2,
+                                      const DegreeBounds& b1, const DegreeBounds& b2)
+{
+    size_t spans[monomial_t::COMPONENTS];
+    for (size_t c = 0; c < monomial_t::COMPONENTS; c++) {
+        if (b1.hi[c] + b2.hi[c] > monomial_t::DEGREE_MAX || b1.lo[c] + b2.lo[c] < monomial_t::DEGREE_MIN) {
+            throw std::runtime_error("Degree overflow");
+        }
+        spans[c] = (b1.hi[c] + b2.hi[c]) - (b1.lo[c] + b2.lo[c]) + 1;
+    }
+
+    const auto substitute = [&spans](const monomial_t& m, const DegreeBounds& b) {
+        size_t idx = 0;
+        for (size_t c = 0; c < monomial_t::COMPONENTS; c++) {
+            idx = idx * spans[c] + (m.degs.get(c) - b.lo[c]);
+        }
+        return idx;
+    };
+
+    const size_t length = kronecker_length(b1, b2);
+
+    std::vector<double> a(length, 0), b(length, 0);
+    for (const auto& m : p1.monomials) {
+        a[substitute(m, b1)] += m.k;
+    }
+    for (const auto& m : p2.monomials) {
+        b[substitute(m, b2)] += m.k;
+    }
+
+    const double bound = coefficients_bound(p1, p2);
+    const size_t primes = Transforms::ntt_primes_required(bound);
+
+    const bool integral = p1.has_integral_coefficients() && p2.has_integral_coefficients();
+
+    std::vector<double> res;
+    if (integral && primes > 0 && length <= Transforms::NTT_MAX_LENGTH) {
+        res = Transforms::convolve_exact(a, b, primes);
+    } else {
+        res = Transforms::convolve_fft(a, b);
+
+        // transform round-off shows up as noise in place of zero coefficients,
+        // and products of integral coefficients are integral anyway, unless they are too large
+        // for a double to hold them exactly, then rounding would not make them any more exact
+        const double noise = fft_error_bound(bound, length);
+        const bool round = integral && bound < 0x1p53;
+        for (auto& k : res) {
+            if (fabs(k) <= noise) {
+                k = 0;
+            } else if (round) {
+                k = std::round(k);
+            }
+        }
+    }
+
+    BasicPolynomial dst;
+    for (size_t i = length; i-- > 0; ) {
+        if (res[i] == 0.0)
+            continue;
+
+        typename monomial_t::Degrees degs = { 0 };
+        size_t idx = i;
+        for (size_t c = monomial_t::COMPONENTS; c-- > 0; ) {
+            degs.set(c, static_cast<typename monomial_t::Degrees::value_t>(idx % spans[c] + b1.lo[c] + b2.lo[c]));
+            idx /= spans[c];
+        }
+        dst.monomials.push_back(monomial_t(res[i], degs));
+    }
+
+    // substitution keeps the lexicographic order only, moreover the packed
+    // comparison treats negative degrees as the largest ones
+    typedef typename monomial_t::order_t order_t;
+    if (order_t::GRADED || order_t::REVERSED || p1.has_negative_degrees() || p2.has_negative_degrees()) {
+        auto& terms = dst.monomials.mutate();
+        std::sort(terms.begin(), terms.end(), OrderFunction);
+    }
+
+    return dst;
+}
+
+// region Parallel Multiplication
+
+//
+// Every worker multiplies its own contiguous slice of the longer operand
+// (slices of an ordered polynomial are ordered as well), then the partial
+// products are merged pairwise, each round of merges running concurrently.
+// The calling thread takes the first slice and the first merge of every round,
+// so one thread less is started for each
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::mult_parallel(const BasicPolynomial& p1, const BasicPolynomial& p2,
+                                     MultiplicationStrategy strategy, size_t threads)
+{
+    const BasicPolynomial& f = (p1.size() >= p2.size()) ? p1 : p2;
+    const BasicPolynomial& g = (p1.size() >= p2.size()) ? p2 : p1;
+
+    const auto multiply_slice = [&f, &g, threads, strategy](size_t t) {
+        const size_t from = f.size() * t / threads, to = f.size() * (t + 1) / threads;
+        BasicPolynomial slice;
+        slice.monomials.assign(f.monomials.cbegin() + from, f.monomials.cbegin() + to);
+        return mult_serial(slice, g, strategy);
+    };
+
+    std::vector<std::future<BasicPolynomial>> tasks;
+    tasks.reserve(threads - 1);
+    for (size_t t = 1; t < threads; t++) {
+        tasks.push_back(std::async(std::launch::async, multiply_slice, t));
+    }
+
+    std::vector<BasicPolynomial> parts;
+    parts.reserve(threads);
+    parts.push_back(multiply_slice(0));
+    for (auto& task : tasks) {
+        parts.push_back(task.get());
+    }
+
+    while (parts.size() > 1) {
+        std::vector<std::future<BasicPolynomial>> merges;
+        for (size_t i = 2; i + 1 < parts.size(); i += 2) {
+            merges.push_back(std::async(std::launch::async, [&parts, i]() {
+                return apply_sum(parts[i], parts[i + 1], 1);
+            }));
+        }
+
+        std::vector<BasicPolynomial> merged;
+        merged.reserve(merges.size() + 2);
+        merged.push_back(apply_sum(parts[0], parts[1], 1));
+        for (auto& merge : merges) {
+            merged.push_back(merge.get());
+        }
+        if (parts.size() % 2) {
+            merged.push_back(std::move(parts.back()));
+        }
+
+        std::swap(parts, merged);
+    }
+
+    return parts.front();
+}
+
+// endregion
+
+// region Squaring
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::square() const
+{
+    if (monomials.empty()) {
+        return {};
+    }
+
+    MultiplicationStrategy strategy = choose_mult_strategy(*this, *this);
+
+    // a single transform or a split between several workers beats halving the products
+    const size_t threads = std::min({ mult_threads(), (size() * size()) / MULT_PARALLEL_GRAIN, size() });
+    if (strategy == MultiplicationStrategy::Kronecker || threads > 2) {
+        return multiply(*this, strategy);
+    }
+
+    if (strategy == MultiplicationStrategy::Heap && !has_negative_degrees()) {
+        return square_heap(*this);
+    }
+
+    const DegreeBounds bounds = degree_bounds();
+    return square_hash(*this, std::min(estimate_product_size(bounds, bounds), size() * (size() + 1) / 2));
+}
+
+//
+// Stream i walks p[i] * p[j] for j >= i, the first product is the square of the term,
+// and the rest are the cross products with their coefficients doubled
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::square_heap(const BasicPolynomial& p)
+{
+    struct Stream {
+        monomial_t head;
+        size_t i, j;
+    };
+    const auto cmp = [](const Stream& a, const Stream& b) {
+        return OrderFunction(b.head, a.head);
+    };
+
+    const auto& terms = p.monomials.view();
+
+    std::vector<Stream> buf;
+    buf.reserve(terms.size());
+    for (size_t i = 0; i < terms.size(); i++) {
+        buf.push_back({ terms[i] * terms[i], i, i });
+    }
+    std::priority_queue<Stream, std::vector<Stream>, decltype(cmp)> heap(cmp, std::move(buf));
+
+    BasicPolynomial dst;
+
+    monomial_t acc(coeff_t(0)); // zero accumulator is never appended
+    while (!heap.empty())
+    {
+        Stream s = heap.top();
+        heap.pop();
+
+        if (acc.cmp_degs(s.head)) {
+            acc += s.head;
+        } else {
+            dst.append(acc);
+            acc = s.head;
+        }
+
+        if (++s.j < terms.size()) {
+            s.head = terms[s.i] * terms[s.j];
+            s.head.k += s.head.k;
+            heap.push(s);
+        }
+    }
+    dst.append(acc);
+
+    return dst;
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::square_hash(const BasicPolynomial& p, size_t expected_size)
+{
+    const auto& terms = p.monomials.view();
+    return accumulate_hash(expected_size, [&terms](auto add) {
+        for (size_t i = 0; i < terms.size(); i++) {
+            add(terms[i] * terms[i]);
+            for (size_t j = i + 1; j < terms.size(); j++) {
+                monomial_t m = terms[i] * terms[j];
+                m.k += m.k;
+                add(m);
+            }
+        }
+    });
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::pow_binomial(const BasicPolynomial& p, unsigned exponent)
+{
+    const monomial_t& a = p.monomials[0];
+    const monomial_t& b = p.monomials[1];
+
+    // the tables below take exponent + 1 terms each, so the degrees are checked before anything is allocated
+    for (const monomial_t* m : { &a, &b }) {
+        for (size_t c = 0; c < monomial_t::COMPONENTS; c++) {
+            const int deg = m->degs.get(c);
+            if ((deg > 0 && exponent > static_cast<unsigned>(monomial_t::DEGREE_MAX / deg))
+                    || (deg < 0 && exponent > static_cast<unsigned>(monomial_t::DEGREE_MIN / deg))) {
+                throw std::runtime_error("Degree overflow");
+            }
+        }
+    }
+
+    // powers of the terms degrees only, the coefficients go separately
+    std::vector<monomial_t> a_pows(exponent + 1, monomial_t(coeff_t(1))), b_pows(exponent + 1, monomial_t(coeff_t(1)));
+    const monomial_t a_unit(coeff_t(1), a.degs), b_unit(coeff_t(1), b.degs);
+    std::vector<coeff_t> a_ks(exponent + 1, coeff_t(1)), b_ks(exponent + 1, coeff_t(1));
+    for (unsigned i = 1; i <= exponent; i++) {
+        a_pows[i] = a_pows[i - 1] * a_unit;
+        b_pows[i] = b_pows[i - 1] * b_unit;
+        a_ks[i] = a_ks[i - 1] * a.k;
+        b_ks[i] = b_ks[i - 1] * b.k;
+    }
+
+    // row of the Pascal's triangle by additions only
+    std::vector<coeff_t> row(exponent + 1, coeff_t(0));
+    row[0] = coeff_t(1);
+    for (unsigned n = 1; n <= exponent; n++) {
+        for (unsigned i = n; i > 0; i--) {
+            row[i] += row[i - 1];
+        }
+    }
+
+    BasicPolynomial dst;
+    dst.monomials.reserve(exponent + 1);
+    for (unsigned i = 0; i <= exponent; i++) {
+        monomial_t term = a_pows[exponent - i] * b_pows[i];
+        term.k = row[i] * a_ks[exponent - i] * b_ks[i];
+        if (!coeff_traits::is_zero(term.k)) {
+            dst.monomials.push_back(std::move(term));
+        }
+    }
+
+    // the terms are distinct, but only non-negative degrees keep them in order
+    if (!std::is_sorted(dst.monomials.cbegin(), dst.monomials.cend(), OrderFunction)) {
+        auto& terms = dst.monomials.mutate();
+        std::sort(terms.begin(), terms.end(), OrderFunction);
+    }
+    return dst;
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::pow(unsigned exponent) const
+{
+    if (exponent == 0) {
+        return BasicPolynomial(monomial_t(coeff_t(1)));
+    }
+
+    switch (monomials.size()) {
+        case 0:
+            return {};
+        case 1:
+            return BasicPolynomial(monomials[0].pow(exponent));
+        case 2:
+            return pow_binomial(*this, exponent);
+        default:
+            break;
+    }
+
+    // left to right, so the multiplications are by the base, which is the smallest operand
+    unsigned bit = 1u << (std::numeric_limits<unsigned>::digits - 1);
+    while (!(exponent & bit)) {
+        bit >>= 1;
+    }
+
+    BasicPolynomial res(*this);
+    for (bit >>= 1; bit; bit >>= 1) {
+        res = res.square();
+        if (exponent & bit) {
+            res = res.multiply(*this);
+        }
+    }
+    return res;
+}
+
+// endregion
+
+// region Substitution
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::substitute(char var, const BasicPolynomial& q) const
+{
+    return compose({ { var, &q } });
+}
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::substitute(const Substitution& substitution) const
+{
+    std::vector<Replacement> replacements;
+    replacements.reserve(substitution.size());
+    for (const auto& [var, q] : substitution) {
+        replacements.push_back({ var, &q });
+    }
+    return compose(replacements);
+}
+
+//
+// Terms are grouped by the degrees of the replaced variables, so that every group is
+// a polynomial c in the rest of them, multiplied by q1^d1 * q2^d2 * ... at once.
+// Powers of every replacement are computed once, each from the previous one,
+// and the group products are combined by a single k-way heap merge
+//
+
+template<typename MonomialT>
+BasicPolynomial<MonomialT> BasicPolynomial<MonomialT>::compose(const std::vector<Replacement>& replacements) const
+{
+    const size_t n = replacements.size();
+
+    struct PowerTable {
+        int lo = 0, hi = 0;
+        std::vector<BasicPolynomial> powers; // -- q^lo, ..., q^hi
+    };
+    std::vector<PowerTable> tables(n);
+
+    for (size_t r = 0; r < n; r++) {
+        const char var = replacements[r].var;
+        const BasicPolynomial& q = *replacements[r].polynomial;
+        if (var < monomial_t::VAR_MIN || var > monomial_t::VAR_MAX) {
+            throw std::invalid_argument("Non-existent variable");
+        }
+
+        PowerTable& t = tables[r];
+        for (const auto& m : monomials) {
+            t.lo = std::min(t.lo, static_cast<int>(m[var]));
+            t.hi = std::max(t.hi, static_cast<int>(m[var]));
+        }
+
+        t.powers.resize(t.hi - t.lo + 1);
+        t.powers[-t.lo] = BasicPolynomial(monomial_t(coeff_t(1)));
+        for (int d = 1; d <= t.hi; d++) {
+            t.powers[d - t.lo] = t.powers[d - 1 - t.lo] * q;
+        }
+        if (t.lo < 0) {
+            if (q.monomials.empty())
+                throw std::domain_error("Division by zero");
+            if (q.size() != 1)
+                throw std::invalid_argument("Negative degrees can only be replaced by a single term");
+
+            const BasicPolynomial inverse(monomial_t(coeff_t(1)) / q.monomials[0]);
+            for (int d = -1; d >= t.lo; d--) {
+                t.powers[d - t.lo] = t.powers[d + 1 - t.lo] * inverse;
+            }
+        }
+    }
+
+    // the replaced degrees are cleared, what is left of the terms is the group polynomial
+    std::map<std::vector<int>, BasicPolynomial> groups;
+    std::vector<int> key(n);
+    for (const auto& m : monomials) {
+        monomial_t rest(m);
+        for (size_t r = 0; r < n; r++) {
+            key[r] = m[replacements[r].var];
+            rest.set_degree(replacements[r].var, 0);
+        }
+        groups[key].monomials.push_back(rest);
+    }
+
+    std::vector<BasicPolynomial> products;
+    products.reserve(groups.size());
+    for (auto& [degs, c] : groups) {
+        // distinct terms stay distinct after clearing the same degrees, only the order may break
+        if (!std::is_sorted(c.monomials.cbegin(), c.monomials.cend(), OrderFunction)) {
+            auto& terms = c.monomials.mutate();
+            std::sort(terms.begin(), terms.end(), OrderFunction);
+        }
+        for (size_t r = 0; r < n; r++) {
+            if (degs[r] != 0) {
+                c *= tables[r].powers[degs[r] - tables[r].lo];
+            }
+        }
+        if (!c.monomials.empty()) {
+            products.push_back(std::move(c));
+        }
+    }
+
+    if (products.size() <= 1) {
+        return products.empty() ? BasicPolynomial() : std::move(products.front());
+    }
+
+    struct Stream {
+        monomial_t head;
+        size_t i, j;
+    };
+    const auto cmp = [](const Stream& a, const Stream& b) {
+        return OrderFunction(b.head, a.head);
+    };
+
+    std::vector<Stream> buf;
+    buf.reserve(products.size());
+    for (size_t i = 0; i < products.size(); i++) {
+        buf.push_back({ products[i].monomials[0], i, 0 });
+    }
+    std::priority_queue<Stream, std::vector<Stream>, decltype(cmp)> heap(cmp, std::move(buf));
+
+    BasicPolynomial dst;
+
+    monomial_t acc(coeff_t(0)); // zero accumulator is never appended
+    while (!heap.empty())
+    {
+        Stream s = heap.top();
+        heap.pop();
+
+        if (acc.cmp_degs(s.head)) {
+            acc += s.head;
+        } else {
+            dst.append(acc);
+            acc = s.head;
+        }
+
+        const auto& terms = products[s.i].monomials.view();
+        if (++s.j < terms.size()) {
+            s.head = terms[s.j];
+            heap.push(s);
+        }
+    }
+    dst.append(acc);
+
+    return dst;
+}
+
+// endregion
+
+// region Sum Expressions
+
+//
+// p1 + p2 - p3 + p4 builds a tree of lightweight nodes instead of
+// intermediate polynomials, and the whole tree gets evaluated with
+// a single k-way merge once it is converted to the polynomial type.
+// Lvalue operands are copied into the nodes, which is O(1) as the copies
+// share the terms storage, so an expression kept around is not affected
+// by later changes to them. Rvalue operands are moved in, and their
+// storage is reused by the merge
+//
+
+template<typename T>
+struct is_basic_polynomial : std::false_type {};
+
+template<typename MonomialT>
+struct is_basic_polynomial<BasicPolynomial<MonomialT>> : std::true_type {};
+
+template<typename T>
+struct is_polynomial_sum : std::false_type {};
+
+template<typename L, typename R>
+struct is_polynomial_sum<PolynomialSum<L, R>> : std::true_type {};
+
+template<typename T>
+constexpr bool is_polynomial_sum_v = is_polynomial_sum<std::decay_t<T>>::value;
+
+// -- either a polynomial or a sum expression, at least one of the operands should be of this kind
+template<typename T>
+constexpr bool is_sum_node_v = is_basic_polynomial<std::decay_t<T>>::value || is_polynomial_sum_v<T>;
+
+template<typename T, bool = is_polynomial_sum_v<T>>
+struct sum_node_polynomial {
+    using type = std::decay_t<T>;
+};
+
+template<typename T>
+struct sum_node_polynomial<T, true> {
+    using type = typename std::decay_t<T>::polynomial_t;
+};
+
+// -- polynomial type of the expression, taken from the operand which is a node
+template<typename L, typename R, typename = void>
+struct sum_result {};
+
+template<typename L, typename R>
+struct sum_result<L, R, std::enable_if_t<is_sum_node_v<L> || is_sum_node_v<R>>> {
+    using polynomial_t = typename std::conditional_t<is_sum_node_v<L>, sum_node_polynomial<L>, sum_node_polynomial<R>>::type;
+};
+
+// -- copies of the lvalue polynomials are const, so their shared storage is never taken over
+template<typename T, typename P>
+using sum_operand_t = std::conditional_t<is_polynomial_sum_v<T>,
+        std::decay_t<T>,
+        std::conditional_t<std::is_lvalue_reference_v<T> && std::is_same_v<std::decay_t<T>, P>,
+                const P,
+                P>>;
+
+template<typename L, typename R>
+class PolynomialSum {
+    template<typename>
+    friend class BasicPolynomial;
+    template<typename, typename>
+    friend class PolynomialSum;
+public:
+    using polynomial_t = typename sum_result<L, R>::polynomial_t;
+private:
+    using operand_t = typename polynomial_t::SumOperand;
+
+    L lhs;
+    R rhs;
+    int sign;
+
+    template<typename T>
+    static constexpr size_t leaves_of()
+    {
+        if constexpr (is_polynomial_sum_v<T>) {
+            return std::decay_t<T>::LEAVES;
+        } else {
+            return 1;
+        }
+    }
+
+    template<typename T>
+    static void collect(const std::remove_reference_t<T>& operand, int operand_sign, operand_t*& out, bool movable)
+    {
+        if constexpr (is_polynomial_sum_v<T>) {
+            operand.collect(operand_sign, out, movable);
+        } else if constexpr (std::is_const_v<T>) {
+            *out++ = { &operand, operand_sign, nullptr };
+        } else {
+            *out++ = { &operand, operand_sign, movable ? const_cast<polynomial_t*>(&operand) : nullptr };
+        }
+    }
+
+    void collect(int outer_sign, operand_t*& out, bool movable) const
+    {
+        collect<L>(lhs, outer_sign, out, movable);
+        collect<R>(rhs, outer_sign * sign, out, movable);
+    }
+
+    polynomial_t evaluate(bool movable) const
+    {
+        operand_t operands[LEAVES];
+        operand_t* out = operands;
+        collect(1, out, movable);
+        return polynomial_t::merge_sum(operands, LEAVES);
+    }
+public:
+    static constexpr size_t LEAVES = leaves_of<L>() + leaves_of<R>();
+
+    template<typename A, typename B>
+    PolynomialSum(A&& lhs, B&& rhs, int sign)
+        : lhs(std::forward<A>(lhs))
+        , rhs(std::forward<B>(rhs))
+        , sign(sign)
+    {}
+
+    polynomial_t operator-() const& { return -evaluate(false); }
+    polynomial_t operator-() && { return -evaluate(true); }
+
+    // -- the polynomial members, every call evaluates the expression anew
+
+    [[nodiscard]] size_t size() const { return evaluate(false).size(); }
+    [[nodiscard]] uint64_t hash() const { return evaluate(false).hash(); }
+
+    [[nodiscard]]
+    double calculate(const typename polynomial_t::monomial_t::Point& point) const
+    {
+        return evaluate(false).calculate(point);
+    }
+    [[nodiscard]]
+    double calculate(const typename polynomial_t::monomial_t::FixedPoint& point) const
+    {
+        return evaluate(false).calculate(point);
+    }
+    [[nodiscard]]
+    std::vector<double> calculate_batch(const std::array<std::vector<double>, polynomial_t::monomial_t::COMPONENTS>& coords) const
+    {
+        return evaluate(false).calculate_batch(coords);
+    }
+
+    [[nodiscard]] polynomial_t differentiate(char variable) const { return evaluate(false).differentiate(variable); }
+    [[nodiscard]] polynomial_t integrate(char variable) const { return evaluate(false).integrate(variable); }
+    [[nodiscard]] polynomial_t square() const { return evaluate(false).square(); }
+    [[nodiscard]] polynomial_t pow(unsigned exponent) const { return evaluate(false).pow(exponent); }
+
+    [[nodiscard]]
+    polynomial_t substitute(char variable, const polynomial_t& q) const
+    {
+        return evaluate(false).substitute(variable, q);
+    }
+    [[nodiscard]]
+    polynomial_t multiply(const polynomial_t& other,
+                          PolynomialBase::MultiplicationStrategy strategy = PolynomialBase::MultiplicationStrategy::Auto) const
+    {
+        return evaluate(false).multiply(other, strategy);
+    }
+
+    bool operator==(const polynomial_t& other) const { return evaluate(false) == other; }
+    bool operator!=(const polynomial_t& other) const { return !(*this == other); }
+
+    friend std::ostream& operator<<(std::ostream& os, const PolynomialSum& sum)
+    {
+        return os << sum.evaluate(false);
+    }
+};
+
+template<typename MonomialT>
+template<typename L, typename R>
+BasicPolynomial<MonomialT>::BasicPolynomial(PolynomialSum<L, R>&& sum)
+    : BasicPolynomial(sum.evaluate(true))
+{}
+
+template<typename MonomialT>
+template<typename L, typename R>
+BasicPolynomial<MonomialT>::BasicPolynomial(const PolynomialSum<L, R>& sum)
+    : BasicPolynomial(sum.evaluate(false))
+{}
+
+// -- the copy of an lvalue operand is taken before the other one is moved from,
+//    so that std::move(p) + p sees p intact
+template<typename P, typename L, typename R>
+PolynomialSum<sum_operand_t<L, P>, sum_operand_t<R, P>> make_polynomial_sum(L&& lhs, R&& rhs, int sign)
+{
+    if constexpr (!std::is_lvalue_reference_v<L> && std::is_lvalue_reference_v<R>) {
+        sum_operand_t<R, P> copy(rhs);
+        return { std::forward<L>(lhs), std::move(copy), sign };
+    } else {
+        return { std::forward<L>(lhs), std::forward<R>(rhs), sign };
+    }
+}
+
+template<typename L, typename R, typename P = typename sum_result<L, R>::polynomial_t,
+        typename = std::enable_if_t<std::is_convertible_v<L, P> && std::is_convertible_v<R, P>>>
+PolynomialSum<sum_operand_t<L, P>, sum_operand_t<R, P>> operator+(L&& lhs, R&& rhs)
+{
+    return make_polynomial_sum<P>(std::forward<L>(lhs), std::forward<R>(rhs), 1);
+}
+
+template<typename L, typename R, typename P = typename sum_result<L, R>::polynomial_t,
+        typename = std::enable_if_t<std::is_convertible_v<L, P> && std::is_convertible_v<R, P>>>
+PolynomialSum<sum_operand_t<L, P>, sum_operand_t<R, P>> operator-(L&& lhs, R&& rhs)
+{
+    return make_polynomial_sum<P>(std::forward<L>(lhs), std::forward<R>(rhs), -1);
+}
+
+// -- products are not fused, so the expression is just evaluated beforehand
+
+template<typename L, typename R, typename T, typename P = typename PolynomialSum<L, R>::polynomial_t>
+auto operator*(PolynomialSum<L, R>&& lhs, T&& rhs) -> decltype(std::declval<P>() * std::forward<T>(rhs))
+{
+    return P(std::move(lhs)) * std::forward<T>(rhs);
+}
+
+template<typename L, typename R, typename T, typename P = typename PolynomialSum<L, R>::polynomial_t>
+auto operator*(const PolynomialSum<L, R>& lhs, T&& rhs) -> decltype(std::declval<P>() * std::forward<T>(rhs))
+{
+    return P(lhs) * std::forward<T>(rhs);
+}
+
+template<typename L, typename R, typename T, typename P = typename PolynomialSum<L, R>::polynomial_t>
+auto operator/(const PolynomialSum<L, R>& lhs, T&& rhs) -> decltype(std::declval<P>() / std::forward<T>(rhs))
+{
+    return P(lhs) / std::forward<T>(rhs);
+}
+
+// endregion
+
+namespace std {
+    template<typename MonomialT>
+    struct hash<BasicPolynomial<MonomialT>> {
+        size_t operator()(const BasicPolynomial<MonomialT>& p) const noexcept
+        {
+            return static_cast<size_t>(p.hash());
+        }
+    };
+}
 
 #endif // __POLYNOMIAL_H__
@@ -23,7 +23,8 @@ private:
     using variable_t = std::string;
     using token_t = std::variant<Operation, value_t, variable_t>;
 
-    static const std::unordered_map<Operation, std::function<value_t (const value_t&, const value_t&)>> OPERATIONS;
+    // -- operands are passed as rvalues, so that their storage can be reused for the result
+    static const std::unordered_map<Operation, std::function<value_t (value_t&&, value_t&&)>> OPERATIONS;
 
     std::vector<token_t> tokens;
     std::set<variable_t> variables;
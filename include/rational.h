@@ -0,0 +1,400 @@
+#ifndef __RATIONAL_H__
+#define __RATIONAL_H__
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "coefficients.h"
+
+//
+// Arbitrary-precision integer, sign and magnitude of 32 bit limbs
+//
+
+class BigInteger {
+public:
+    typedef std::vector<uint32_t> limbs_t;
+private:
+    // -- little-endian, without leading zero limbs, so zero has none
+    limbs_t limbs;
+    bool negative = false;
+
+    void trim() noexcept;
+
+    static int compare_magnitudes(const limbs_t& a, const limbs_t& b) noexcept;
+    static limbs_t add_magnitudes(const limbs_t& a, const limbs_t& b);
+    // -- a should not be less than b
+    static limbs_t subtract_magnitudes(const limbs_t& a, const limbs_t& b);
+    static limbs_t multiply_magnitudes(const limbs_t& a, const limbs_t& b);
+    // -- long division (Knuth, algorithm D), b should not be zero
+    static void divide_magnitudes(const limbs_t& a, const limbs_t& b, limbs_t& quotient, limbs_t& remainder);
+    // -- divides in place, returns the remainder
+    static uint32_t divide_magnitude(limbs_t& a, uint32_t divisor) noexcept;
+
+    static BigInteger add(const BigInteger& a, const BigInteger& b, bool subtract);
+public:
+    BigInteger() = default;
+    BigInteger(int64_t value);
+    // -- decimal digits with an optional sign
+    explicit BigInteger(const std::string& raw);
+
+    [[nodiscard]] bool is_zero() const noexcept;
+    [[nodiscard]] bool is_negative() const noexcept;
+    // -- INT64_MIN is reported as not fitting, so that the inline values can always be negated
+    [[nodiscard]] bool fits_int64() const noexcept;
+    [[nodiscard]] int64_t to_int64() const noexcept;
+    [[nodiscard]] double to_double() const noexcept;
+    [[nodiscard]] std::string to_string() const;
+    [[nodiscard]] uint64_t hash() const noexcept;
+
+    // -- truncating division, as the built-in one
+    static void divmod(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder);
+    // -- non-negative
+    static BigInteger gcd(BigInteger a, BigInteger b);
+
+    [[nodiscard]] int compare(const BigInteger& other) const noexcept;
+
+    bool operator==(const BigInteger& other) const noexcept;
+    bool operator!=(const BigInteger& other) const noexcept;
+    bool operator<(const BigInteger& other) const noexcept;
+    bool operator>(const BigInteger& other) const noexcept;
+
+    BigInteger operator-() const;
+    BigInteger abs() const;
+    //
+    BigInteger operator+(const BigInteger& other) const;
+    BigInteger operator-(const BigInteger& other) const;
+    BigInteger operator*(const BigInteger& other) const;
+    BigInteger operator/(const BigInteger& other) const;
+    BigInteger operator%(const BigInteger& other) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const BigInteger& n)
+    {
+        return os << n.to_string();
+    }
+};
+
+//
+// Exact rational number, always in lowest terms with a positive denominator.
+// Values stay inline in a pair of int64 while they fit, and the arithmetic on them
+// only checks for overflow, falling back to the heap allocated big integers then.
+// Big values which fit again after an operation are moved back inline,
+// so a value is never both representable inline and kept on the heap
+//
+
+class BigRational {
+private:
+    struct Big {
+        BigInteger num;
+        BigInteger den;
+    };
+
+    int64_t num = 0;
+    int64_t den = 1;
+    // -- set only while the value does not fit inline, never mutated so copies can share it
+    std::shared_ptr<const Big> big;
+
+    // -- checked operations, INT64_MIN counts as an overflow too
+    static bool add_overflows(int64_t a, int64_t b, int64_t& res) noexcept;
+    static bool sub_overflows(int64_t a, int64_t b, int64_t& res) noexcept;
+    static bool mul_overflows(int64_t a, int64_t b, int64_t& res) noexcept;
+
+    // -- den should be positive
+    void assign_inline(int64_t n, int64_t d) noexcept;
+    void assign(BigInteger n, BigInteger d);
+
+    [[nodiscard]] BigInteger big_num() const;
+    [[nodiscard]] BigInteger big_den() const;
+
+    // -- out of line fallbacks for the values which do not fit
+    void add_big(const BigRational& other, bool subtract);
+    void mul_big(const BigRational& other, bool divide);
+    [[nodiscard]] int compare_big(const BigRational& other) const;
+public:
+    BigRational(int64_t num = 0, int64_t den = 1);
+    BigRational(const BigInteger& num, const BigInteger& den = 1);
+    // -- integers, fractions "p/q" and decimals "d.ddd", with an optional sign
+    explicit BigRational(const std::string& raw);
+
+    // -- true while the value is kept inline
+    [[nodiscard]] bool is_inline() const noexcept;
+    [[nodiscard]] bool is_zero() const noexcept;
+    [[nodiscard]] bool is_integer() const noexcept;
+
+    [[nodiscard]] BigInteger numerator() const;
+    [[nodiscard]] BigInteger denominator() const;
+
+    [[nodiscard]] double to_double() const noexcept;
+    [[nodiscard]] std::string to_string() const;
+    // -- the representation is unique, so equal values hash equally
+    [[nodiscard]] uint64_t hash() const noexcept;
+
+    [[nodiscard]] int compare(const BigRational& other) const;
+
+    bool operator==(const BigRational& other) const noexcept;
+    bool operator!=(const BigRational& other) const noexcept;
+    bool operator<(const BigRational& other) const;
+    bool operator>(const BigRational& other) const;
+    bool operator<=(const BigRational& other) const;
+    bool operator>=(const BigRational& other) const;
+
+    BigRational operator-() const;
+    //
+    BigRational operator+(const BigRational& other) const;
+    BigRational& operator+=(const BigRational& other);
+    //
+    BigRational operator-(const BigRational& other) const;
+    BigRational& operator-=(const BigRational& other);
+    //
+    BigRational operator*(const BigRational& other) const;
+    BigRational& operator*=(const BigRational& other);
+    //
+    BigRational operator/(const BigRational& other) const;
+    BigRational& operator/=(const BigRational& other);
+
+    friend std::ostream& operator<<(std::ostream& os, const BigRational& r)
+    {
+        return os << r.to_string();
+    }
+};
+
+template<>
+struct CoefficientTraits<BigRational> {
+    static constexpr bool APPROXIMATE = false;
+
+    static bool is_zero(const BigRational& k) noexcept { return k.is_zero(); }
+    static bool is_negative(const BigRational& k) { return k < BigRational(0); }
+    static double to_double(const BigRational& k) noexcept { return k.to_double(); }
+    static uint64_t hash(const BigRational& k) noexcept { return k.hash(); }
+
+    // -- takes the longest run of digits, '.' and '/', and parses it exactly
+    template<class Reader>
+    static bool read(Reader& reader, BigRational& k)
+    {
+        std::string raw;
+        for (char c = reader.peek(); (c >= '0' && c <= '9') || c == '.' || c == '/'; c = reader.peek()) {
+            raw.push_back(c);
+            reader.skip();
+        }
+
+        if (raw.empty())
+            return false;
+
+        k = BigRational(raw);
+        return true;
+    }
+};
+
+// region Inline Arithmetic
+
+inline bool BigRational::add_overflows(int64_t a, int64_t b, int64_t& res) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_add_overflow(a, b, &res) || res == std::numeric_limits<int64_t>::min();
+#else
+    if ((b > 0 && a > std::numeric_limits<int64_t>::max() - b) || (b < 0 && a <= std::numeric_limits<int64_t>::min() - b))
+        return true;
+    res = a + b;
+    return false;
+#endif
+}
+
+inline bool BigRational::sub_overflows(int64_t a, int64_t b, int64_t& res) noexcept
+{
+    // inline values are never INT64_MIN, so the negation is safe
+    return add_overflows(a, -b, res);
+}
+
+inline bool BigRational::mul_overflows(int64_t a, int64_t b, int64_t& res) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_mul_overflow(a, b, &res) || res == std::numeric_limits<int64_t>::min();
+#else
+    if (a == 0 || b == 0) {
+        res = 0;
+        return false;
+    }
+    const uint64_t ua = a < 0 ? 0 - static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+    const uint64_t ub = b < 0 ? 0 - static_cast<uint64_t>(b) : static_cast<uint64_t>(b);
+    if (ua > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) / ub)
+        return true;
+    res = a * b;
+    return false;
+#endif
+}
+
+inline void BigRational::assign_inline(int64_t n, int64_t d) noexcept
+{
+    const int64_t g = std::gcd(n, d);
+    num = n / g;
+    den = d / g;
+    big.reset();
+}
+
+inline bool BigRational::is_inline() const noexcept
+{
+    return !big;
+}
+
+inline bool BigRational::is_zero() const noexcept
+{
+    return !big && num == 0;
+}
+
+inline bool BigRational::operator==(const BigRational& other) const noexcept
+{
+    if (!big && !other.big)
+        return num == other.num && den == other.den;
+    // the representation is unique, big values never equal the inline ones
+    if (!big || !other.big)
+        return false;
+    return big->num == other.big->num && big->den == other.big->den;
+}
+
+inline bool BigRational::operator!=(const BigRational& other) const noexcept
+{
+    return !(*this == other);
+}
+
+inline BigRational& BigRational::operator+=(const BigRational& other)
+{
+    if (!big && !other.big) {
+        int64_t n, d, a, b;
+        if (den == other.den) {
+            if (!add_overflows(num, other.num, n)) {
+                assign_inline(n, den);
+                return *this;
+            }
+        } else if (!mul_overflows(num, other.den, a) && !mul_overflows(other.num, den, b)
+                   && !add_overflows(a, b, n) && !mul_overflows(den, other.den, d)) {
+            assign_inline(n, d);
+            return *this;
+        }
+    }
+
+    add_big(other, false);
+    return *this;
+}
+
+inline BigRational& BigRational::operator-=(const BigRational& other)
+{
+    if (!big && !other.big) {
+        int64_t n, d, a, b;
+        if (den == other.den) {
+            if (!sub_overflows(num, other.num, n)) {
+                assign_inline(n, den);
+                return *this;
+            }
+        } else if (!mul_overflows(num, other.den, a) && !mul_overflows(other.num, den, b)
+                   && !sub_overflows(a, b, n) && !mul_overflows(den, other.den, d)) {
+            assign_inline(n, d);
+            return *this;
+        }
+    }
+
+    add_big(other, true);
+    return *this;
+}
+
+inline BigRational& BigRational::operator*=(const BigRational& other)
+{
+    if (!big && !other.big) {
+        // cross reduction keeps the result in lowest terms
+        const int64_t g1 = std::gcd(num, other.den);
+        const int64_t g2 = std::gcd(other.num, den);
+        int64_t n, d;
+        if (!mul_overflows(num / g1, other.num / g2, n) && !mul_overflows(den / g2, other.den / g1, d)) {
+            num = n;
+            den = n == 0 ? 1 : d;
+            return *this;
+        }
+    }
+
+    mul_big(other, false);
+    return *this;
+}
+
+inline BigRational& BigRational::operator/=(const BigRational& other)
+{
+    if (other.is_zero())
+        throw std::domain_error("Division by zero");
+
+    if (!big && !other.big) {
+        const int64_t g1 = std::gcd(num, other.num);
+        const int64_t g2 = std::gcd(other.den, den);
+        int64_t n, d;
+        if (!mul_overflows(num / g1, other.den / g2, n) && !mul_overflows(den / g2, other.num / g1, d)) {
+            num = d < 0 ? -n : n;
+            den = n == 0 ? 1 : (d < 0 ? -d : d);
+            return *this;
+        }
+    }
+
+    mul_big(other, true);
+    return *this;
+}
+
+inline BigRational BigRational::operator+(const BigRational& other) const
+{
+    BigRational res(*this);
+    return res += other;
+}
+
+inline BigRational BigRational::operator-(const BigRational& other) const
+{
+    BigRational res(*this);
+    return res -= other;
+}
+
+inline BigRational BigRational::operator*(const BigRational& other) const
+{
+    BigRational res(*this);
+    return res *= other;
+}
+
+inline BigRational BigRational::operator/(const BigRational& other) const
+{
+    BigRational res(*this);
+    return res /= other;
+}
+
+inline int BigRational::compare(const BigRational& other) const
+{
+    if (!big && !other.big) {
+        int64_t a, b;
+        if (den == other.den)
+            return (num > other.num) - (num < other.num);
+        if (!mul_overflows(num, other.den, a) && !mul_overflows(other.num, den, b))
+            return (a > b) - (a < b);
+    }
+    return compare_big(other);
+}
+
+inline bool BigRational::operator<(const BigRational& other) const
+{
+    return compare(other) < 0;
+}
+
+inline bool BigRational::operator>(const BigRational& other) const
+{
+    return compare(other) > 0;
+}
+
+inline bool BigRational::operator<=(const BigRational& other) const
+{
+    return compare(other) <= 0;
+}
+
+inline bool BigRational::operator>=(const BigRational& other) const
+{
+    return compare(other) >= 0;
+}
+
+// endregion
+
+#endif // __RATIONAL_H__
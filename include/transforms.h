@@ -0,0 +1,38 @@
+#ifndef __TRANSFORMS_H__
+#define __TRANSFORMS_H__
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+namespace Transforms {
+    struct NttPrime {
+        uint32_t modulus;
+        uint32_t root; // primitive root
+    };
+
+    // -- c * 2^k + 1 primes, all of them support transforms up to 2^23 long
+    static constexpr NttPrime NTT_PRIMES[] = {
+            { 998244353, 3 }, // 119 * 2^23 + 1
+            { 469762049, 3 }, //   7 * 2^26 + 1
+            { 167772161, 3 }, //   5 * 2^25 + 1
+    };
+    static constexpr size_t NTT_PRIMES_COUNT = std::size(NTT_PRIMES);
+    static constexpr size_t NTT_MAX_LENGTH = size_t(1) << 23;
+
+    // -- in-place transforms, length should be a power of two
+    void fft(std::vector<std::complex<double>>& a, bool invert);
+    void ntt(std::vector<uint32_t>& a, const NttPrime& prime, bool invert);
+
+    // -- cyclic convolutions, both operands should be of the same power of two length
+    std::vector<double> convolve_fft(const std::vector<double>& a, const std::vector<double>& b);
+    std::vector<uint32_t> convolve_ntt(std::vector<uint32_t> a, std::vector<uint32_t> b, const NttPrime& prime);
+
+    // -- least number of primes for exact convolution of integers with
+    //    result magnitude up to bound, zero if even all of them are not enough
+    size_t ntt_primes_required(double bound);
+    // -- exact convolution of integral values over the given number of primes, recombined by CRT
+    std::vector<double> convolve_exact(const std::vector<double>& a, const std::vector<double>& b, size_t primes);
+}
+
+#endif // __TRANSFORMS_H__
@@ -18,11 +18,7 @@ int main()
     cout << " ? Enter 'discard' to input another polynomial" << endl;
     cout << endl;
 
-    Monomial::Point point = {
-            { 'x', 0 },
-            { 'y', 0 },
-            { 'z', 0 },
-    };
+    Monomial::FixedPoint point = {};
 
     std::shared_ptr<Polynomial> polynomial;
 
@@ -65,8 +61,8 @@ int main()
                     cout << "<<< " << polynomial << endl;
                 }
             } else if ("evaluate" == input) {
-                for (auto& item : point) {
-                    cin >> item.second;
+                for (double& coordinate : point) {
+                    cin >> coordinate;
                 }
                 cout << "<<< " << polynomial->calculate(point) << endl;
             } else if ("discard" == input) {
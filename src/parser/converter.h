@@ -57,12 +57,12 @@ public:
 
     void exitAtomicVariable(AlgebraicExpressionParser::AtomicVariableContext *ctx) override {
         buf.atom = ctx->getText()[0];
-        buf.monomial[buf.atom] = 1;
+        buf.monomial.set_degree(buf.atom, 1);
     }
 
     void exitCoefficient(AlgebraicExpressionParser::CoefficientContext *ctx) override {
         if (buf.atom) {
-            buf.monomial[buf.atom] = std::stoi(ctx->getText());
+            buf.monomial.set_degree(buf.atom, std::stoi(ctx->getText()));
         } else {
             buf.monomial.set_coefficient(std::stod(ctx->getText()));
         }
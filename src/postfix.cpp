@@ -4,7 +4,7 @@
 
 const std::unordered_map<
         AlgebraicExpression::Operation,
-        std::function<Polynomial(const Polynomial &, const Polynomial &)>
+        std::function<Polynomial(Polynomial&&, Polynomial&&)>
 > AlgebraicExpression::OPERATIONS = {
         { Operation::Plus, std::plus{} },
         { Operation::Minus, std::minus{} },
@@ -42,9 +42,9 @@ AlgebraicExpression::value_t AlgebraicExpression::evaluate(const std::unordered_
     for (const auto& lexeme : tokens)
     {
         if (const auto operation(std::get_if<Operation>(&lexeme)); operation) {
-            auto rhs = stack.top(); stack.pop();
-            auto lhs = stack.top(); stack.pop();
-            stack.push(OPERATIONS.at(*operation)(lhs, rhs));
+            auto rhs = std::move(stack.top()); stack.pop();
+            auto lhs = std::move(stack.top()); stack.pop();
+            stack.push(OPERATIONS.at(*operation)(std::move(lhs), std::move(rhs)));
         } else if (std::holds_alternative<value_t>(lexeme)) {
             stack.push(std::get<value_t>(lexeme));
         } else if (std::holds_alternative<variable_t>(lexeme)) {
@@ -57,5 +57,5 @@ AlgebraicExpression::value_t AlgebraicExpression::evaluate(const std::unordered_
         }
     }
 
-    return stack.top();
+    return std::move(stack.top());
 }
@@ -0,0 +1,582 @@
+#include "rational.h"
+
+#include <algorithm>
+#include <utility>
+
+// region BigInteger
+
+static void pop_leading_zeros(BigInteger::limbs_t& limbs) noexcept
+{
+    while (!limbs.empty() && limbs.back() == 0) {
+        limbs.pop_back();
+    }
+}
+
+static bool is_digits(const std::string& raw) noexcept
+{
+    return !raw.empty() && std::all_of(raw.begin(), raw.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+BigInteger::BigInteger(int64_t value)
+    : negative(value < 0)
+{
+    uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    for (; magnitude; magnitude >>= 32) {
+        limbs.push_back(static_cast<uint32_t>(magnitude));
+    }
+}
+
+BigInteger::BigInteger(const std::string& raw)
+{
+    const bool signed_raw = !raw.empty() && (raw[0] == '-' || raw[0] == '+');
+    const std::string digits = signed_raw ? raw.substr(1) : raw;
+    if (!is_digits(digits)) {
+        throw std::invalid_argument("Invalid integer");
+    }
+
+    // nine decimal digits at a time still fit into a limb
+    for (size_t pos = 0; pos < digits.size(); ) {
+        uint32_t chunk = 0, scale = 1;
+        for (const size_t end = std::min(pos + 9, digits.size()); pos < end; pos++) {
+            chunk = chunk * 10 + (digits[pos] - '0');
+            scale *= 10;
+        }
+
+        uint64_t carry = chunk;
+        for (auto& limb : limbs) {
+            const uint64_t cur = static_cast<uint64_t>(limb) * scale + carry;
+            limb = static_cast<uint32_t>(cur);
+            carry = cur >> 32;
+        }
+        if (carry) {
+            limbs.push_back(static_cast<uint32_t>(carry));
+        }
+    }
+
+    negative = signed_raw && raw[0] == '-';
+    trim();
+}
+
+void BigInteger::trim() noexcept
+{
+    pop_leading_zeros(limbs);
+    if (limbs.empty()) {
+        negative = false;
+    }
+}
+
+int BigInteger::compare_magnitudes(const limbs_t& a, const limbs_t& b) noexcept
+{
+    if (a.size() != b.size())
+        return a.size() < b.size() ? -1 : 1;
+
+    for (size_t i = a.size(); i-- > 0; ) {
+        if (a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+BigInteger::limbs_t BigInteger::add_magnitudes(const limbs_t& a, const limbs_t& b)
+{
+    const limbs_t& longer = a.size() < b.size() ? b : a;
+    const limbs_t& shorter = a.size() < b.size() ? a : b;
+
+    limbs_t res(longer.size() + 1);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < longer.size(); i++) {
+        const uint64_t sum = carry + longer[i] + (i < shorter.size() ? shorter[i] : 0);
+        res[i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+    }
+    res[longer.size()] = static_cast<uint32_t>(carry);
+
+    pop_leading_zeros(res);
+    return res;
+}
+
+BigInteger::limbs_t BigInteger::subtract_magnitudes(const limbs_t& a, const limbs_t& b)
+{
+    limbs_t res(a.size());
+    int64_t borrow = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        const int64_t diff = static_cast<int64_t>(a[i]) - (i < b.size() ? b[i] : 0) - borrow;
+        borrow = diff < 0;
+        res[i] = static_cast<uint32_t>(diff);
+    }
+
+    pop_leading_zeros(res);
+    return res;
+}
+
+BigInteger::limbs_t BigInteger::multiply_magnitudes(const limbs_t& a, const limbs_t& b)
+{
+    if (a.empty() || b.empty())
+        return {};
+
+    limbs_t res(a.size() + b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < b.size(); j++) {
+            // (2^32 - 1)^2 + 2 * (2^32 - 1) does not overflow
+            const uint64_t cur = static_cast<uint64_t>(a[i]) * b[j] + res[i + j] + carry;
+            res[i + j] = static_cast<uint32_t>(cur);
+            carry = cur >> 32;
+        }
+        res[i + b.size()] = static_cast<uint32_t>(carry);
+    }
+
+    pop_leading_zeros(res);
+    return res;
+}
+
+uint32_t BigInteger::divide_magnitude(limbs_t& a, uint32_t divisor) noexcept
+{
+    uint64_t rem = 0;
+    for (size_t i = a.size(); i-- > 0; ) {
+        const uint64_t cur = (rem << 32) | a[i];
+        a[i] = static_cast<uint32_t>(cur / divisor);
+        rem = cur % divisor;
+    }
+
+    pop_leading_zeros(a);
+    return static_cast<uint32_t>(rem);
+}
+
+void BigInteger::divide_magnitudes(const limbs_t& a, const limbs_t& b, limbs_t& quotient, limbs_t& remainder)
+{
+    if (compare_magnitudes(a, b) < 0) {
+        quotient.clear();
+        remainder = a;
+        return;
+    }
+
+    if (b.size() == 1) {
+        quotient = a;
+        const uint32_t rem = divide_magnitude(quotient, b[0]);
+        remainder.assign(rem ? 1 : 0, rem);
+        return;
+    }
+
+    const size_t n = b.size(), m = a.size();
+    const uint64_t base = uint64_t(1) << 32;
+
+    // normalize, so the top limb of the divisor has its high bit set
+    // and the quotient digit estimates are off by at most two
+    int shift = 0;
+    for (uint32_t top = b.back(); !(top & 0x80000000u); top <<= 1) {
+        shift++;
+    }
+
+    limbs_t bn(n), an(m + 1);
+    for (size_t i = n; i-- > 1; ) {
+        bn[i] = static_cast<uint32_t>((static_cast<uint64_t>(b[i]) << shift) | (static_cast<uint64_t>(b[i - 1]) >> (32 - shift)));
+    }
+    bn[0] = b[0] << shift;
+
+    an[m] = static_cast<uint32_t>(static_cast<uint64_t>(a[m - 1]) >> (32 - shift));
+    for (size_t i = m; i-- > 1; ) {
+        an[i] = static_cast<uint32_t>((static_cast<uint64_t>(a[i]) << shift) | (static_cast<uint64_t>(a[i - 1]) >> (32 - shift)));
+    }
+    an[0] = a[0] << shift;
+
+    quotient.assign(m - n + 1, 0);
+    for (size_t j = m - n + 1; j-- > 0; ) {
+        const uint64_t top = (static_cast<uint64_t>(an[j + n]) << 32) | an[j + n - 1];
+        uint64_t qhat = top / bn[n - 1];
+        uint64_t rhat = top % bn[n - 1];
+
+        while (qhat >= base || qhat * bn[n - 2] > ((rhat << 32) | an[j + n - 2])) {
+            qhat--;
+            rhat += bn[n - 1];
+            if (rhat >= base)
+                break;
+        }
+
+        // multiply and subtract
+        int64_t borrow = 0, t;
+        for (size_t i = 0; i < n; i++) {
+            const uint64_t p = qhat * bn[i];
+            t = static_cast<int64_t>(an[i + j]) - borrow - static_cast<int64_t>(p & 0xFFFFFFFFu);
+            an[i + j] = static_cast<uint32_t>(t);
+            borrow = static_cast<int64_t>(p >> 32) - (t >> 32);
+        }
+        t = static_cast<int64_t>(an[j + n]) - borrow;
+        an[j + n] = static_cast<uint32_t>(t);
+
+        // the estimate was one too large, add the divisor back
+        if (t < 0) {
+            qhat--;
+            uint64_t carry = 0;
+            for (size_t i = 0; i < n; i++) {
+                const uint64_t sum = static_cast<uint64_t>(an[i + j]) + bn[i] + carry;
+                an[i + j] = static_cast<uint32_t>(sum);
+                carry = sum >> 32;
+            }
+            an[j + n] = static_cast<uint32_t>(an[j + n] + carry);
+        }
+
+        quotient[j] = static_cast<uint32_t>(qhat);
+    }
+
+    remainder.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        remainder[i] = static_cast<uint32_t>((static_cast<uint64_t>(an[i]) >> shift) | (static_cast<uint64_t>(an[i + 1]) << (32 - shift)));
+    }
+
+    pop_leading_zeros(quotient);
+    pop_leading_zeros(remainder);
+}
+
+bool BigInteger::is_zero() const noexcept
+{
+    return limbs.empty();
+}
+
+bool BigInteger::is_negative() const noexcept
+{
+    return negative;
+}
+
+bool BigInteger::fits_int64() const noexcept
+{
+    return limbs.size() < 2 || (limbs.size() == 2 && !(limbs[1] & 0x80000000u));
+}
+
+int64_t BigInteger::to_int64() const noexcept
+{
+    uint64_t magnitude = 0;
+    for (size_t i = std::min<size_t>(limbs.size(), 2); i-- > 0; ) {
+        magnitude = (magnitude << 32) | limbs[i];
+    }
+    const auto value = static_cast<int64_t>(magnitude);
+    return negative ? -value : value;
+}
+
+double BigInteger::to_double() const noexcept
+{
+    double res = 0;
+    for (size_t i = limbs.size(); i-- > 0; ) {
+        res = res * 4294967296.0 + limbs[i];
+    }
+    return negative ? -res : res;
+}
+
+std::string BigInteger::to_string() const
+{
+    if (limbs.empty())
+        return "0";
+
+    // nine decimal digits per division
+    std::vector<uint32_t> chunks;
+    for (limbs_t rest = limbs; !rest.empty(); ) {
+        chunks.push_back(divide_magnitude(rest, 1000000000u));
+    }
+
+    std::string res = negative ? "-" : "";
+    res += std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0; ) {
+        const std::string chunk = std::to_string(chunks[i]);
+        res.append(9 - chunk.size(), '0');
+        res += chunk;
+    }
+    return res;
+}
+
+uint64_t BigInteger::hash() const noexcept
+{
+    uint64_t h = negative;
+    for (const uint32_t limb : limbs) {
+        h = Hashing::combine(h, limb);
+    }
+    return h;
+}
+
+void BigInteger::divmod(const BigInteger& a, const BigInteger& b, BigInteger& quotient, BigInteger& remainder)
+{
+    if (b.is_zero()) {
+        throw std::domain_error("Division by zero");
+    }
+
+    divide_magnitudes(a.limbs, b.limbs, quotient.limbs, remainder.limbs);
+    quotient.negative = a.negative != b.negative;
+    remainder.negative = a.negative;
+    quotient.trim();
+    remainder.trim();
+}
+
+BigInteger BigInteger::gcd(BigInteger a, BigInteger b)
+{
+    a.negative = b.negative = false;
+
+    BigInteger quotient, remainder;
+    while (!b.is_zero()) {
+        divmod(a, b, quotient, remainder);
+        a = std::move(b);
+        b = std::move(remainder);
+    }
+    return a;
+}
+
+int BigInteger::compare(const BigInteger& other) const noexcept
+{
+    if (negative != other.negative)
+        return negative ? -1 : 1;
+
+    const int res = compare_magnitudes(limbs, other.limbs);
+    return negative ? -res : res;
+}
+
+bool BigInteger::operator==(const BigInteger& other) const noexcept
+{
+    return negative == other.negative && limbs == other.limbs;
+}
+
+bool BigInteger::operator!=(const BigInteger& other) const noexcept
+{
+    return !(*this == other);
+}
+
+bool BigInteger::operator<(const BigInteger& other) const noexcept
+{
+    return compare(other) < 0;
+}
+
+bool BigInteger::operator>(const BigInteger& other) const noexcept
+{
+    return compare(other) > 0;
+}
+
+BigInteger BigInteger::add(const BigInteger& a, const BigInteger& b, bool subtract)
+{
+    const bool b_negative = subtract ? !b.negative : b.negative;
+
+    BigInteger res;
+    if (a.negative == b_negative) {
+        res.limbs = add_magnitudes(a.limbs, b.limbs);
+        res.negative = a.negative;
+    } else if (compare_magnitudes(a.limbs, b.limbs) >= 0) {
+        res.limbs = subtract_magnitudes(a.limbs, b.limbs);
+        res.negative = a.negative;
+    } else {
+        res.limbs = subtract_magnitudes(b.limbs, a.limbs);
+        res.negative = b_negative;
+    }
+
+    res.trim();
+    return res;
+}
+
+BigInteger BigInteger::operator-() const
+{
+    BigInteger res(*this);
+    res.negative = !negative && !limbs.empty();
+    return res;
+}
+
+BigInteger BigInteger::abs() const
+{
+    BigInteger res(*this);
+    res.negative = false;
+    return res;
+}
+
+BigInteger BigInteger::operator+(const BigInteger& other) const
+{
+    return add(*this, other, false);
+}
+
+BigInteger BigInteger::operator-(const BigInteger& other) const
+{
+    return add(*this, other, true);
+}
+
+BigInteger BigInteger::operator*(const BigInteger& other) const
+{
+    BigInteger res;
+    res.limbs = multiply_magnitudes(limbs, other.limbs);
+    res.negative = negative != other.negative;
+    res.trim();
+    return res;
+}
+
+BigInteger BigInteger::operator/(const BigInteger& other) const
+{
+    BigInteger quotient, remainder;
+    divmod(*this, other, quotient, remainder);
+    return quotient;
+}
+
+BigInteger BigInteger::operator%(const BigInteger& other) const
+{
+    BigInteger quotient, remainder;
+    divmod(*this, other, quotient, remainder);
+    return remainder;
+}
+
+// endregion
+
+// region BigRational
+
+BigRational::BigRational(int64_t num, int64_t den)
+{
+    if (den == 0) {
+        throw std::domain_error("Zero denominator");
+    }
+
+    if (num == std::numeric_limits<int64_t>::min() || den == std::numeric_limits<int64_t>::min()) {
+        assign(num, den);
+        return;
+    }
+
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    assign_inline(num, den);
+}
+
+BigRational::BigRational(const BigInteger& num, const BigInteger& den)
+{
+    if (den.is_zero()) {
+        throw std::domain_error("Zero denominator");
+    }
+    assign(num, den);
+}
+
+BigRational::BigRational(const std::string& raw)
+{
+    const bool signed_raw = !raw.empty() && (raw[0] == '-' || raw[0] == '+');
+    const size_t slash = raw.find('/');
+    const std::string value = raw.substr(signed_raw ? 1 : 0, slash == std::string::npos ? std::string::npos : slash - signed_raw);
+
+    const size_t dot = value.find('.');
+    const std::string whole = value.substr(0, dot);
+    const std::string fraction = dot == std::string::npos ? "" : value.substr(dot + 1);
+
+    // either part of a decimal may be omitted, but not both
+    if ((!whole.empty() && !is_digits(whole)) || (!fraction.empty() && !is_digits(fraction)) || whole.size() + fraction.size() == 0) {
+        throw std::invalid_argument("Invalid rational number");
+    }
+
+    BigInteger n(whole + fraction);
+    BigInteger d("1" + std::string(fraction.size(), '0'));
+
+    if (slash != std::string::npos) {
+        const std::string tail = raw.substr(slash + 1);
+        if (!is_digits(tail)) {
+            throw std::invalid_argument("Invalid rational number");
+        }
+        d = d * BigInteger(tail);
+    }
+
+    if (d.is_zero()) {
+        throw std::domain_error("Zero denominator");
+    }
+
+    assign(signed_raw && raw[0] == '-' ? -n : n, d);
+}
+
+void BigRational::assign(BigInteger n, BigInteger d)
+{
+    if (d.is_negative()) {
+        n = -n;
+        d = -d;
+    }
+
+    const BigInteger g = BigInteger::gcd(n, d);
+    if (g != 1) {
+        n = n / g;
+        d = d / g;
+    }
+
+    if (n.fits_int64() && d.fits_int64()) {
+        num = n.to_int64();
+        den = d.to_int64();
+        big.reset();
+    } else {
+        num = 0;
+        den = 1;
+        big = std::make_shared<Big>(Big{ std::move(n), std::move(d) });
+    }
+}
+
+BigInteger BigRational::big_num() const
+{
+    return big ? big->num : BigInteger(num);
+}
+
+BigInteger BigRational::big_den() const
+{
+    return big ? big->den : BigInteger(den);
+}
+
+void BigRational::add_big(const BigRational& other, bool subtract)
+{
+    const BigInteger a = big_num() * other.big_den();
+    const BigInteger b = other.big_num() * big_den();
+    assign(subtract ? a - b : a + b, big_den() * other.big_den());
+}
+
+void BigRational::mul_big(const BigRational& other, bool divide)
+{
+    if (divide) {
+        assign(big_num() * other.big_den(), big_den() * other.big_num());
+    } else {
+        assign(big_num() * other.big_num(), big_den() * other.big_den());
+    }
+}
+
+int BigRational::compare_big(const BigRational& other) const
+{
+    return (big_num() * other.big_den()).compare(other.big_num() * big_den());
+}
+
+bool BigRational::is_integer() const noexcept
+{
+    return big ? big->den == 1 : den == 1;
+}
+
+BigInteger BigRational::numerator() const
+{
+    return big_num();
+}
+
+BigInteger BigRational::denominator() const
+{
+    return big_den();
+}
+
+double BigRational::to_double() const noexcept
+{
+    if (big)
+        return big->num.to_double() / big->den.to_double();
+    return static_cast<double>(num) / static_cast<double>(den);
+}
+
+std::string BigRational::to_string() const
+{
+    if (is_integer())
+        return big_num().to_string();
+    return big_num().to_string() + "/" + big_den().to_string();
+}
+
+uint64_t BigRational::hash() const noexcept
+{
+    if (big)
+        return Hashing::combine(big->num.hash(), big->den.hash());
+    return Hashing::combine(static_cast<uint64_t>(num), static_cast<uint64_t>(den));
+}
+
+BigRational BigRational::operator-() const
+{
+    BigRational res(*this);
+    if (big) {
+        res.big = std::make_shared<Big>(Big{ -big->num, big->den });
+    } else {
+        res.num = -num;
+    }
+    return res;
+}
+
+// endregion
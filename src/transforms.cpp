@@ -0,0 +1,236 @@
+#include "transforms.h"
+
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace Transforms {
+
+    inline bool is_pow2(size_t n)
+    {
+        return n && !(n & (n - 1));
+    }
+
+    template<typename T>
+    void bit_reverse_permute(std::vector<T>& a)
+    {
+        const size_t n = a.size();
+        for (size_t i = 1, j = 0; i < n; i++) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+            j ^= bit;
+
+            if (i < j) {
+                std::swap(a[i], a[j]);
+            }
+        }
+    }
+
+    inline uint32_t mul_mod(uint32_t a, uint32_t b, uint32_t mod)
+    {
+        return static_cast<uint32_t>(static_cast<uint64_t>(a) * b % mod);
+    }
+
+    inline uint32_t pow_mod(uint32_t base, uint64_t exp, uint32_t mod)
+    {
+        uint32_t res = 1;
+        for (; exp; exp >>= 1) {
+            if (exp & 1) {
+                res = mul_mod(res, base, mod);
+            }
+            base = mul_mod(base, base, mod);
+        }
+        return res;
+    }
+
+    inline uint32_t inv_mod(uint32_t a, uint32_t mod)
+    {
+        return pow_mod(a, mod - 2, mod);
+    }
+
+    void fft(std::vector<std::complex<double>>& a, bool invert)
+    {
+        const size_t n = a.size();
+        assert(is_pow2(n) && "Length should be a power of two");
+
+        bit_reverse_permute(a);
+
+        // roots are computed directly rather than by repeated
+        // multiplication, which keeps the rounding error flat
+        std::vector<std::complex<double>> roots(n / 2);
+        const double angle = (invert ? -2 : 2) * std::acos(-1.0) / static_cast<double>(n);
+        for (size_t i = 0; i < n / 2; i++) {
+            roots[i] = std::polar(1.0, angle * static_cast<double>(i));
+        }
+
+        for (size_t len = 2; len <= n; len <<= 1) {
+            const size_t step = n / len;
+            for (size_t i = 0; i < n; i += len) {
+                for (size_t j = 0; j < len / 2; j++) {
+                    const std::complex<double> u = a[i + j];
+                    const std::complex<double> v = a[i + j + len / 2] * roots[j * step];
+                    a[i + j] = u + v;
+                    a[i + j + len / 2] = u - v;
+                }
+            }
+        }
+
+        if (invert) {
+            for (auto& x : a) {
+                x /= static_cast<double>(n);
+            }
+        }
+    }
+
+    void ntt(std::vector<uint32_t>& a, const NttPrime& prime, bool invert)
+    {
+        const size_t n = a.size();
+        const uint32_t mod = prime.modulus;
+        assert(is_pow2(n) && n <= NTT_MAX_LENGTH && "Length should be a power of two within the modulus limits");
+
+        bit_reverse_permute(a);
+
+        for (size_t len = 2; len <= n; len <<= 1) {
+            uint32_t w_len = pow_mod(prime.root, (mod - 1) / len, mod);
+            if (invert) {
+                w_len = inv_mod(w_len, mod);
+            }
+
+            for (size_t i = 0; i < n; i += len) {
+                uint32_t w = 1;
+                for (size_t j = 0; j < len / 2; j++) {
+                    const uint32_t u = a[i + j];
+                    const uint32_t v = mul_mod(a[i + j + len / 2], w, mod);
+                    a[i + j] = (u + v < mod) ? u + v : u + v - mod;
+                    a[i + j + len / 2] = (u >= v) ? u - v : u + mod - v;
+                    w = mul_mod(w, w_len, mod);
+                }
+            }
+        }
+
+        if (invert) {
+            const uint32_t n_inv = inv_mod(static_cast<uint32_t>(n % mod), mod);
+            for (auto& x : a) {
+                x = mul_mod(x, n_inv, mod);
+            }
+        }
+    }
+
+    std::vector<double> convolve_fft(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        assert(a.size() == b.size() && "Operands length mismatch");
+
+        // both real operands are transformed at once as a + ib
+        std::vector<std::complex<double>> buf(a.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            buf[i] = { a[i], b[i] };
+        }
+        fft(buf, false);
+
+        // (a + ib)^2 = a^2 - b^2 + 2iab, so the product is a half of the imaginary part
+        for (auto& x : buf) {
+            x *= x;
+        }
+        fft(buf, true);
+
+        std::vector<double> res(a.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            res[i] = buf[i].imag() / 2;
+        }
+        return res;
+    }
+
+    std::vector<uint32_t> convolve_ntt(std::vector<uint32_t> a, std::vector<uint32_t> b, const NttPrime& prime)
+    {
+        assert(a.size() == b.size() && "Operands length mismatch");
+
+        ntt(a, prime, false);
+        ntt(b, prime, false);
+        for (size_t i = 0; i < a.size(); i++) {
+            a[i] = mul_mod(a[i], b[i], prime.modulus);
+        }
+        ntt(a, prime, true);
+
+        return a;
+    }
+
+    size_t ntt_primes_required(double bound)
+    {
+        // a quarter of the moduli product keeps the sign recovery unambiguous
+        double range = 0.25;
+        for (size_t i = 0; i < NTT_PRIMES_COUNT; i++) {
+            range *= NTT_PRIMES[i].modulus;
+            if (bound < range) {
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
+    //
+    // Garner's algorithm recovers the mixed radix digits t of the value
+    // x = t0 + t1 * m0 + t2 * m0 * m1 from its residues, the value is negative
+    // when the leading digit is past the half of its modulus
+    //
+
+    std::vector<double> convolve_exact(const std::vector<double>& a, const std::vector<double>& b, size_t primes)
+    {
+        assert(primes > 0 && primes <= NTT_PRIMES_COUNT && "Unsupported primes count");
+
+        const size_t n = a.size();
+
+        std::vector<uint32_t> residues[NTT_PRIMES_COUNT];
+        for (size_t p = 0; p < primes; p++) {
+            const uint32_t mod = NTT_PRIMES[p].modulus;
+            const auto to_residue = [mod](double v) {
+                const double r = std::fmod(v, static_cast<double>(mod)); // exact for integral values
+                return static_cast<uint32_t>(r < 0 ? r + mod : r);
+            };
+
+            std::vector<uint32_t> ra(n), rb(n);
+            for (size_t i = 0; i < n; i++) {
+                ra[i] = to_residue(a[i]);
+                rb[i] = to_residue(b[i]);
+            }
+            residues[p] = convolve_ntt(std::move(ra), std::move(rb), NTT_PRIMES[p]);
+        }
+
+        // inv[p][q] = m_q^-1 (mod m_p)
+        uint32_t inv[NTT_PRIMES_COUNT][NTT_PRIMES_COUNT] = {};
+        for (size_t p = 0; p < primes; p++) {
+            for (size_t q = 0; q < p; q++) {
+                inv[p][q] = inv_mod(NTT_PRIMES[q].modulus % NTT_PRIMES[p].modulus, NTT_PRIMES[p].modulus);
+            }
+        }
+
+        std::vector<double> res(n);
+        uint32_t t[NTT_PRIMES_COUNT];
+        for (size_t i = 0; i < n; i++) {
+            for (size_t p = 0; p < primes; p++) {
+                const uint32_t mod = NTT_PRIMES[p].modulus;
+                uint32_t x = residues[p][i];
+                for (size_t q = 0; q < p; q++) {
+                    const uint32_t tq = t[q] % mod;
+                    x = mul_mod(x >= tq ? x - tq : x + mod - tq, inv[p][q], mod);
+                }
+                t[p] = x;
+            }
+
+            const bool negative = t[primes - 1] > NTT_PRIMES[primes - 1].modulus / 2;
+
+            double value = 0;
+            for (size_t p = primes; p-- > 0; ) {
+                const double digit = negative
+                        ? static_cast<double>(t[p]) - static_cast<double>(NTT_PRIMES[p].modulus - 1)
+                        : static_cast<double>(t[p]);
+                value = value * NTT_PRIMES[p].modulus + digit;
+            }
+            res[i] = negative ? value - 1 : value;
+        }
+
+        return res;
+    }
+
+}
@@ -0,0 +1,40 @@
+#include <gtest.h>
+#include "modular.h"
+#include <cstdint>
+#include <stdexcept>
+
+TEST(MontgomeryInt, keeps_residues)
+{
+    typedef MontgomeryInt<998244353> Mod;
+
+    EXPECT_EQ(5u, Mod(5).residue());
+    EXPECT_EQ(998244353u - 5, Mod(-5).residue());
+    EXPECT_EQ(-5, Mod(-5).to_signed());
+    EXPECT_TRUE(Mod(998244353).is_zero());
+}
+
+TEST(MontgomeryInt, multiplies_near_the_modulus)
+{
+    const uint64_t p = Modular::PRIME_63;
+
+    // (p - 1)^2 = 1, (p - 2) * (p - 3) = 6 mod p
+    EXPECT_EQ(1u, (Mod63(-1) * Mod63(-1)).residue());
+    EXPECT_EQ(6u, (Mod63(-2) * Mod63(-3)).residue());
+    EXPECT_EQ(p - 2, (Mod63(-1) + Mod63(-1)).residue());
+}
+
+TEST(MontgomeryInt, can_divide)
+{
+    const Mod63 a(123456789), b(987654321);
+
+    EXPECT_EQ(a, (a / b) * b);
+    EXPECT_EQ(Mod63(1), b * b.inverse());
+    EXPECT_THROW(a / Mod63(0), std::domain_error);
+}
+
+TEST(MontgomeryInt, can_raise_to_power)
+{
+    // Fermat's little theorem
+    EXPECT_EQ(Mod63(1), Mod63(3).pow(Modular::PRIME_63 - 1));
+    EXPECT_EQ(Mod63(1024), Mod63(2).pow(10));
+}
@@ -88,6 +88,41 @@ TEST(Monomial, fails_on_missing_expected_degree)
     EXPECT_ANY_THROW(Monomial m("32x^z^50"));
 }
 
+TEST(Monomial, can_parse_monomials_of_many_variables)
+{
+    using Monomial16 = BasicMonomial<16>;
+
+    Monomial16 monomial("3kp^2z^5");
+
+    EXPECT_EQ(3, monomial.coefficient());
+    EXPECT_EQ(1, monomial['k']);
+    EXPECT_EQ(2, monomial['p']);
+    EXPECT_EQ(5, monomial['z']);
+    EXPECT_EQ(0, monomial['x']);
+    EXPECT_ANY_THROW(Monomial16 m("3j"));
+}
+
+TEST(Monomial, wide_monomials_keep_lexicographic_order)
+{
+    using Monomial16 = BasicMonomial<16>;
+
+    // the first and the last variables are packed into different words
+    EXPECT_GT(Monomial16("k"), Monomial16("z^100"));
+    EXPECT_GT(Monomial16("kz"), Monomial16("k"));
+    EXPECT_LT(Monomial16("q^3"), Monomial16("p"));
+}
+
+TEST(Monomial, can_use_wider_degrees)
+{
+    using MonomialShort = BasicMonomial<3, short>;
+
+    MonomialShort monomial("x^1000z^-300");
+
+    EXPECT_EQ(1000, monomial['x']);
+    EXPECT_EQ(-300, monomial['z']);
+    EXPECT_EQ(MonomialShort("x^2000z^-600"), monomial * monomial);
+}
+
 TEST(Monomial, can_calculate)
 {
     const int k = 10, degX = 1, degY = 2, degZ = 3;
@@ -106,3 +141,13 @@ TEST(Monomial, can_calculate)
 
     EXPECT_EQ(result, monomial.calculate(point));
 }
+
+TEST(Monomial, can_calculate_at_fixed_point)
+{
+    const Monomial monomial(3, 2, 0, -1);
+    const Monomial::FixedPoint point = { 1.5, 100, 4 };
+
+    EXPECT_EQ(3 * 1.5 * 1.5 / 4, monomial.calculate(point));
+    EXPECT_EQ(monomial.calculate({ { 'x', 1.5 }, { 'z', 4 } }), monomial.calculate(point));
+    EXPECT_EQ(2u, Monomial::slot('z'));
+}
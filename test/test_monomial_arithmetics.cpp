@@ -104,6 +104,41 @@ TEST(Monomial, can_assignment_multiply_monomials)
     }
 }
 
+TEST(Monomial, can_multiply_monomials_with_negative_degrees)
+{
+    Monomial m1("x^-3y^2z^100"), m2("x^5y^-7z^-120");
+
+    EXPECT_EQ(Monomial("x^2y^-5z^-20"), m1 * m2);
+}
+
+TEST(Monomial, multiplication_detects_degree_overflow)
+{
+    Monomial m1("x^100y^2"), m2("x^27y^3z"), m3("x^28");
+
+    EXPECT_NO_THROW(m1 * m2);
+    EXPECT_ANY_THROW(m1 * m3);
+    EXPECT_ANY_THROW(Monomial("z^-100") * Monomial("z^-29"));
+}
+
+TEST(Monomial, failed_multiplication_keeps_operand)
+{
+    Monomial m("x^100y^2"), expected = m;
+
+    EXPECT_ANY_THROW(m *= Monomial("x^50y"));
+    EXPECT_EQ(expected, m);
+}
+
+TEST(Monomial, multiplication_detects_degree_overflow_in_any_word)
+{
+    using Monomial16 = BasicMonomial<16>;
+
+    Monomial16 m("k^2r^100z^100");
+
+    EXPECT_EQ(Monomial16("k^4r^100z^127"), m * Monomial16("k^2z^27"));
+    EXPECT_ANY_THROW(m * Monomial16("z^28"));
+    EXPECT_ANY_THROW(m * Monomial16("r^28"));
+}
+
 //
 
 TEST(Monomial, can_divide_monomials)
@@ -1,5 +1,9 @@
 #include <gtest.h>
+#include "chained_hashtable.h"
 #include "polynomial.h"
+#include <atomic>
+#include <thread>
+#include <vector>
 
 TEST(Polynomial, can_parse_signed)
 {
@@ -46,6 +50,52 @@ TEST(Polynomial, monomials_are_sorted_by_descending_degrees)
     EXPECT_EQ(Monomial("xyz"), p[3]);
 }
 
+TEST(Polynomial, can_sort_by_graded_lex_order)
+{
+    using PolynomialDegLex = BasicPolynomial<BasicMonomial<3, char, MonomialOrder::GradedLex>>;
+    using MonomialDegLex = PolynomialDegLex::monomial_t;
+
+    PolynomialDegLex p("x^2 + y^3 + xz^2 + z + xyz");
+
+    ASSERT_EQ(5, p.size());
+    EXPECT_EQ(MonomialDegLex("xyz"), p[0]);
+    EXPECT_EQ(MonomialDegLex("xz^2"), p[1]);
+    EXPECT_EQ(MonomialDegLex("y^3"), p[2]);
+    EXPECT_EQ(MonomialDegLex("x^2"), p[3]);
+    EXPECT_EQ(MonomialDegLex("z"), p[4]);
+}
+
+TEST(Polynomial, can_sort_by_graded_reverse_lex_order)
+{
+    using PolynomialDegRevLex = BasicPolynomial<BasicMonomial<3, char, MonomialOrder::GradedReverseLex>>;
+    using MonomialDegRevLex = PolynomialDegRevLex::monomial_t;
+
+    PolynomialDegRevLex p("x^2 + y^3 + xz^2 + z + xyz");
+
+    ASSERT_EQ(5, p.size());
+    EXPECT_EQ(MonomialDegRevLex("y^3"), p[0]);
+    EXPECT_EQ(MonomialDegRevLex("xyz"), p[1]);
+    EXPECT_EQ(MonomialDegRevLex("xz^2"), p[2]);
+    EXPECT_EQ(MonomialDegRevLex("x^2"), p[3]);
+    EXPECT_EQ(MonomialDegRevLex("z"), p[4]);
+}
+
+TEST(Polynomial, graded_order_survives_arithmetics)
+{
+    using PolynomialDegRevLex = BasicPolynomial<BasicMonomial<3, char, MonomialOrder::GradedReverseLex>>;
+    using Strategy = PolynomialDegRevLex::MultiplicationStrategy;
+
+    PolynomialDegRevLex p1("x^2 + y^3 - 2xz + z"), p2("xy - z^2 + 3");
+    const PolynomialDegRevLex res = p1 * p2 + p2 - p1;
+
+    for (size_t i = 1; i < res.size(); i++) {
+        EXPECT_GE(res[i - 1].total_degree(), res[i].total_degree());
+        EXPECT_GT(res[i - 1], res[i]);
+    }
+    EXPECT_EQ(p1.multiply(p2, Strategy::Heap), p1.multiply(p2, Strategy::Kronecker));
+    EXPECT_EQ(p1.multiply(p2, Strategy::Hash), p1.multiply(p2, Strategy::Kronecker));
+}
+
 TEST(Polynomial, zero_is_not_being_added)
 {
     Polynomial p("0xyz");
@@ -62,6 +112,74 @@ TEST(Polynomial, can_compact)
     EXPECT_EQ(Monomial("2xyz"), p[0]);
 }
 
+TEST(Polynomial, insert_combines_similar_monomials)
+{
+    Polynomial p;
+    p.insert(Monomial(2, 1, 1, 1));
+    p.insert(Monomial(1, 2, 0, 0));
+    p.insert(Monomial(3, 1, 1, 1));
+
+    ASSERT_EQ(2, p.size());
+    EXPECT_EQ(Monomial(1, 2, 0, 0), p[0]);
+    EXPECT_EQ(Monomial(5, 1, 1, 1), p[1]);
+}
+
+TEST(Polynomial, insert_drops_cancelled_monomials)
+{
+    Polynomial p("x^2 + xyz - xyz");
+
+    ASSERT_EQ(1, p.size());
+    EXPECT_EQ(Monomial("x^2"), p[0]);
+}
+
+TEST(Polynomial, copies_do_not_see_each_other_changes)
+{
+    const Polynomial original("3x^2 - y + 1");
+    Polynomial copy(original), other(original);
+
+    copy.insert(Monomial("y"));
+    other += other * Polynomial("z");
+    other -= original;
+
+    EXPECT_EQ(Polynomial("3x^2 - y + 1"), original);
+    EXPECT_EQ(Polynomial("3x^2 + 1"), copy);
+    EXPECT_EQ(Polynomial("3x^2z - yz + z"), other);
+}
+
+TEST(Polynomial, copies_can_be_dropped_by_other_threads)
+{
+    Polynomial p("x^2 + 2xy + y^2");
+    std::atomic<size_t> sizes = 0;
+
+    // every worker reads its copy and drops it on exit, while the original gets modified
+    std::vector<std::thread> workers;
+    for (int i = 0; i < 4; i++) {
+        workers.emplace_back([copy = p, &sizes]() {
+            sizes += copy.size();
+        });
+    }
+    p.insert(Monomial("z"));
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    p.insert(Monomial("-z"));
+
+    EXPECT_EQ(12, sizes);
+    EXPECT_EQ(Polynomial("x^2 + 2xy + y^2"), p);
+}
+
+TEST(Polynomial, can_add_a_copy_of_itself)
+{
+    Polynomial p("x - y");
+    const Polynomial q(p);
+
+    p += q;
+    p += p;
+
+    EXPECT_EQ(Polynomial("4x - 4y"), p);
+    EXPECT_EQ(Polynomial("x - y"), q);
+}
+
 TEST(Polynomial, can_calculate)
 {
     const std::unordered_map<char, double> point = {
@@ -79,3 +197,120 @@ TEST(Polynomial, can_calculate)
 
     EXPECT_EQ(res, p.calculate(point));
 }
+
+TEST(Polynomial, can_calculate_at_fixed_point)
+{
+    const Polynomial p("-32x^10z^5 + 90x^5y^10z^3 + 7");
+    Polynomial::monomial_t::FixedPoint point;
+    point[Monomial::slot('x')] = 1.5;
+    point[Monomial::slot('y')] = -0.5;
+    point[Monomial::slot('z')] = 2;
+
+    EXPECT_EQ(p.calculate({ { 'x', 1.5 }, { 'y', -0.5 }, { 'z', 2 } }), p.calculate(point));
+}
+
+TEST(Polynomial, can_calculate_batch)
+{
+    Polynomial p("3x^5y^2 + 7z^9 - x + 11");
+    p.insert(Monomial(-2, 1, -1, 3));
+
+    // more points than a single block
+    std::array<std::vector<double>, 3> coords;
+    for (size_t i = 0; i < 150; i++) {
+        coords[0].push_back(0.5 + 0.01 * i);
+        coords[1].push_back(1.5 - 0.005 * i);
+        coords[2].push_back(-1.0 + 0.02 * i);
+    }
+
+    const std::vector<double> res = p.calculate_batch(coords);
+
+    ASSERT_EQ(150, res.size());
+    for (size_t i = 0; i < res.size(); i++) {
+        const double expected = p.calculate({ { 'x', coords[0][i] }, { 'y', coords[1][i] }, { 'z', coords[2][i] } });
+        EXPECT_NEAR(expected, res[i], 1e-12 * std::max(1.0, std::fabs(expected)));
+    }
+}
+
+TEST(Polynomial, calculate_batch_skips_absent_variables)
+{
+    const Polynomial p("x^2 + 1");
+
+    const std::vector<double> res = p.calculate_batch({ std::vector<double>{ 1, 2, 3 }, {}, {} });
+
+    EXPECT_EQ(std::vector<double>({ 2, 5, 10 }), res);
+    EXPECT_ANY_THROW(static_cast<void>(Polynomial("y").calculate_batch({ std::vector<double>{ 1, 2, 3 }, {}, {} })));
+}
+
+TEST(Polynomial, compiled_plan_matches_calculate)
+{
+    Polynomial p("3x^5y^2 + 7z^9 - x + 2xyz + 11");
+    p.insert(Monomial(-2, 1, -1, 3));
+    p.insert(Monomial(0.5, -2, 0, 0));
+    const auto plan = p.compile();
+
+    for (double x : { 0.5, 1.25, -2.0 }) {
+        const double expected = p.calculate({ { 'x', x }, { 'y', 0.75 }, { 'z', -1.5 } });
+        EXPECT_NEAR(expected, plan({ x, 0.75, -1.5 }), 1e-12 * std::fabs(expected));
+    }
+}
+
+TEST(Polynomial, compiled_plan_uses_horner_scheme)
+{
+    // x^4 + x^3 + x^2 + x + 1 needs one multiplication per degree
+    const auto dense = Polynomial("x^4 + x^3 + x^2 + x + 1").compile();
+    // x^10 + x^9 needs a step to bridge x^9, and a power to multiply it by
+    const auto sparse = Polynomial("x^10 + x^9").compile();
+
+    EXPECT_EQ(4, dense.multiplications());
+    EXPECT_EQ(2, sparse.multiplications());
+    EXPECT_EQ(0, Polynomial().compile()({ 1, 2, 3 }));
+}
+
+TEST(Polynomial, equal_polynomials_hash_equally)
+{
+    const Polynomial p("3x^4y^2 - 2x^3z + 7xy^5z^2 + 4y - 1");
+    Polynomial q;
+    q.insert(Monomial("4y"));
+    q.insert(Monomial("7xy^5z^2"));
+    q.insert(Monomial("-1"));
+    q.insert(Monomial("3x^4y^2"));
+
+    // the hash of q is kept up to date by the inserts from now on
+    EXPECT_NE(p.hash(), q.hash());
+    q.insert(Monomial("-2x^3z"));
+    EXPECT_EQ(p.hash(), q.hash());
+    q.insert(Monomial("x^3z"));
+    q.insert(Monomial("-x^3z"));
+    EXPECT_EQ(p.hash(), q.hash());
+    EXPECT_EQ(p, q);
+
+    EXPECT_EQ(p.hash(), Polynomial(q - Polynomial("0") * q).hash());
+    EXPECT_EQ(std::hash<Polynomial>{}(p), std::hash<Polynomial>{}(q));
+    EXPECT_EQ(std::hash<Monomial>{}(p[0]), std::hash<Monomial>{}(q[0]));
+}
+
+TEST(Polynomial, hash_follows_changes)
+{
+    Polynomial p("x + y");
+    const uint64_t before = p.hash();
+
+    p += Polynomial("z");
+    EXPECT_NE(before, p.hash());
+    EXPECT_EQ(Polynomial("x + y + z").hash(), p.hash());
+
+    Polynomial q("x");
+    static_cast<void>(q.hash());
+    q.insert(Monomial("y"));
+    EXPECT_EQ(before, q.hash());
+}
+
+TEST(Polynomial, can_be_hash_table_key)
+{
+    ChainedHashTable<Polynomial, int> table;
+    table[Polynomial("x^2 - 1")] = 1;
+    table[Polynomial("x + 1") * Polynomial("x - 1")] += 1;
+    table[Polynomial("x^2 + 1")] = 5;
+
+    EXPECT_EQ(2u, table.size());
+    EXPECT_EQ(2, table.at(Polynomial("-1 + x^2")));
+}
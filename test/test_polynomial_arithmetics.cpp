@@ -1,5 +1,7 @@
 #include <gtest.h>
+#include "modular.h"
 #include "polynomial.h"
+#include "rational.h"
 #include <optional>
 #include <unordered_map>
 
@@ -31,6 +33,60 @@ TEST(Polynomial, can_assignment_add_polynomials)
     EXPECT_EQ(expected, p1);
 }
 
+TEST(Polynomial, can_assignment_add_interleaved_polynomials)
+{
+    Polynomial p1("x^5 + 2x^3 + x"), p2("x^4 - 2x^3 + x^2 + 1");
+    Polynomial expected("x^5 + x^4 + x^2 + x + 1");
+
+    ASSERT_NO_THROW(p1 += p2);
+
+    EXPECT_EQ(expected, p1);
+}
+
+TEST(Polynomial, can_assignment_subtract_polynomials)
+{
+    Polynomial p1("x^2 + 3xy + y^2"), p2("xy + y^2");
+    Polynomial expected("x^2 + 2xy");
+
+    ASSERT_NO_THROW(p1 -= p2);
+
+    EXPECT_EQ(expected, p1);
+}
+
+TEST(Polynomial, can_assignment_add_itself)
+{
+    Polynomial p("x^2 + 3xy");
+    Polynomial expected("2x^2 + 6xy");
+
+    ASSERT_NO_THROW(p += p);
+    EXPECT_EQ(expected, p);
+
+    ASSERT_NO_THROW(p -= p);
+    EXPECT_EQ(0, p.size());
+}
+
+TEST(Polynomial, can_chain_operations_on_temporaries)
+{
+    const Polynomial a("x + 1"), b("x - 1"), c("y^2"), d("2"), e("x^2 + y");
+    Polynomial expected("2y^2 - y - 1");
+
+    EXPECT_EQ(expected, a * b + c * d - e);
+    EXPECT_EQ(-expected, e - (a * b + c * d));
+    EXPECT_EQ(-expected, -(a * b + c * d - e));
+}
+
+TEST(Polynomial, operations_on_temporaries_keep_lvalue_operands)
+{
+    const Polynomial a("x^2 + 3xy"), b("xy - y^2");
+    const Polynomial copyA = a, copyB = b;
+
+    const Polynomial res = a - (b + Polynomial("z")) + (Polynomial("z") - a) * b;
+
+    EXPECT_EQ(copyA, a);
+    EXPECT_EQ(copyB, b);
+    EXPECT_EQ(a - b - Polynomial("z") + (Polynomial("z") - a) * b, res);
+}
+
 TEST(Polynomial, similar_monomials_get_compacted)
 {
     Polynomial p1("xyz"), p2("xyz");
@@ -39,6 +95,98 @@ TEST(Polynomial, similar_monomials_get_compacted)
     EXPECT_EQ(expected, p1 + p2);
 }
 
+TEST(Polynomial, can_subtract_polynomials)
+{
+    Polynomial p1("x^3 + 2x^2y + 5z"), p2("x^2y + y^4 - 5z");
+    Polynomial expected("x^3 + x^2y - y^4 + 10z");
+
+    EXPECT_EQ(expected, p1 - p2);
+}
+
+TEST(Polynomial, opposite_monomials_cancel_out)
+{
+    Polynomial p1("xyz + x^2"), p2("xyz");
+
+    const Polynomial res = p1 - p2;
+
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(Monomial("x^2"), res[0]);
+}
+
+TEST(Polynomial, sum_keeps_monomials_sorted)
+{
+    Polynomial p1("x^5 + x^3 + x"), p2("x^4 + x^2 + 1");
+
+    const Polynomial res = p1 + p2;
+
+    ASSERT_EQ(6, res.size());
+    for (size_t i = 1; i < res.size(); i++) {
+        EXPECT_GT(res[i - 1], res[i]);
+    }
+}
+
+TEST(Polynomial, can_sum_several_polynomials_at_once)
+{
+    const Polynomial a("x^3 + xy"), b("x^2 - xy + 1"), c("y^2 - 1"), d("x^3 + z");
+    Polynomial expected("x^2 + y^2 - z");
+
+    const Polynomial res = a + b + c - d;
+
+    EXPECT_EQ(expected, res);
+}
+
+TEST(Polynomial, multi_operand_sum_cancels_to_zero)
+{
+    const Polynomial a("x^2 + y"), b("y - z"), c("x^2 - z");
+
+    const Polynomial res = a + b - c - Polynomial("y") - Monomial("y");
+
+    EXPECT_EQ(0, res.size());
+}
+
+TEST(Polynomial, multi_operand_sum_keeps_monomials_sorted)
+{
+    const Polynomial a("x^5 + x^2"), b("x^4 + x"), c("x^3 + 1");
+
+    const Polynomial res = c + (b + a);
+
+    ASSERT_EQ(6, res.size());
+    for (size_t i = 1; i < res.size(); i++) {
+        EXPECT_GT(res[i - 1], res[i]);
+    }
+}
+
+TEST(Polynomial, sum_expression_is_not_affected_by_later_changes)
+{
+    Polynomial a("x + 1"), b("y");
+
+    const auto sum = a + b;
+    a = Polynomial("z");
+
+    EXPECT_EQ(Polynomial("x + y + 1"), Polynomial(sum));
+}
+
+TEST(Polynomial, sum_expression_reads_operand_before_moving_it)
+{
+    Polynomial a("x + 1"), b("x + 1");
+
+    const Polynomial res = std::move(a) + b;
+    const Polynomial aliased = std::move(b) + b;
+
+    EXPECT_EQ(Polynomial("2x + 2"), res);
+    EXPECT_EQ(Polynomial("2x + 2"), aliased);
+}
+
+TEST(Polynomial, sum_expression_forwards_polynomial_members)
+{
+    const Polynomial a("x^2 + y"), b("y - 1");
+
+    EXPECT_EQ(3, (a + b).size());
+    EXPECT_DOUBLE_EQ(11.0, (a + b).calculate({ { 'x', 2.0 }, { 'y', 4.0 } }));
+    EXPECT_EQ(Polynomial("x^2 + 2y - 1").hash(), (a + b).hash());
+    EXPECT_EQ(Polynomial("2x"), (a - b).differentiate('x'));
+}
+
 //
 
 TEST(Polynomial, can_multiply_polynomials)
@@ -59,6 +207,309 @@ TEST(Polynomial, can_assignment_multiply_polynomials)
     EXPECT_EQ(expected, p1);
 }
 
+TEST(Polynomial, can_assignment_multiply_by_monomial)
+{
+    Polynomial p("x^2 + 3xy - z"), m("2xz");
+    Polynomial expected("2x^3z + 6x^2yz - 2xz^2");
+
+    ASSERT_NO_THROW(p *= m);
+
+    EXPECT_EQ(expected, p);
+}
+
+TEST(Polynomial, failed_assignment_multiplication_keeps_operand)
+{
+    Polynomial p("x^100 + x"), m("x^100");
+    const Polynomial copy = p;
+
+    EXPECT_ANY_THROW(p *= m);
+
+    EXPECT_EQ(copy, p);
+}
+
+TEST(Polynomial, product_combines_similar_monomials)
+{
+    Polynomial p1("x + y"), p2("x + y");
+    Polynomial expected("x^2 + 2xy + y^2");
+
+    const Polynomial res = p1 * p2;
+
+    EXPECT_EQ(3, res.size());
+    EXPECT_EQ(expected, res);
+}
+
+TEST(Polynomial, product_drops_cancelled_monomials)
+{
+    Polynomial p1("x + 1"), p2("x - 1");
+    Polynomial expected("x^2 - 1");
+
+    EXPECT_EQ(expected, p1 * p2);
+}
+
+TEST(Polynomial, can_multiply_dense_polynomials)
+{
+    Polynomial p("x + y + z + 1");
+    Polynomial expected("x^2 + y^2 + z^2 + 2xy + 2xz + 2yz + 2x + 2y + 2z + 1");
+
+    EXPECT_EQ(expected, p * p);
+}
+
+TEST(Polynomial, multiplication_strategies_agree)
+{
+    using Strategy = Polynomial::MultiplicationStrategy;
+
+    Polynomial p1("3x^4y^2 - 2x^3z + 7xy^5z^2 + 4y - 1"), p2("-x^2y^3 + 5xz^4 + 2y^2z - 9");
+    const Polynomial expected = p1.multiply(p2, Strategy::Hash);
+
+    EXPECT_EQ(expected, p1.multiply(p2, Strategy::Heap));
+    EXPECT_EQ(expected, p1.multiply(p2, Strategy::Kronecker));
+    EXPECT_EQ(expected, p1 * p2);
+}
+
+TEST(Polynomial, multiplication_strategies_agree_for_many_variables)
+{
+    using Polynomial16 = BasicPolynomial<BasicMonomial<16>>;
+    using Strategy = Polynomial16::MultiplicationStrategy;
+
+    Polynomial16 p1("3k^2mz - 2l^3 + 7pqr^2 + 4y - 1"), p2("-k^3z^2 + 5mr + 2lx^2 - 9");
+    const Polynomial16 expected = p1.multiply(p2, Strategy::Hash);
+
+    EXPECT_EQ(Polynomial16("-3k^5mz^3 + 15k^2m^2rz + 6k^2lmx^2z - 27k^2mz"), expected
+            - Polynomial16("-2l^3 + 7pqr^2 + 4y - 1") * p2);
+    EXPECT_EQ(expected, p1.multiply(p2, Strategy::Heap));
+    EXPECT_EQ(expected, p1.multiply(p2, Strategy::Kronecker));
+    EXPECT_EQ(expected, p1 * p2);
+
+    // the bounding box of sparse terms is too large for the substitution
+    const Polynomial16 sparse("k^60l^60m^60n^60o^60p^60 + z");
+    EXPECT_EQ(sparse.multiply(sparse, Strategy::Hash), sparse.multiply(sparse, Strategy::Kronecker));
+}
+
+TEST(Polynomial, can_multiply_by_kronecker_substitution_with_fractional_coefficients)
+{
+    Polynomial p1("0.5x + 0.25y"), p2("0.5x - 0.25y");
+    Polynomial expected("0.25x^2 - 0.0625y^2");
+
+    const Polynomial res = p1.multiply(p2, Polynomial::MultiplicationStrategy::Kronecker);
+
+    ASSERT_EQ(expected.size(), res.size());
+    for (size_t i = 0; i < res.size(); i++) {
+        EXPECT_TRUE(expected[i].cmp_degs(res[i]));
+        EXPECT_DOUBLE_EQ(expected[i].coefficient(), res[i].coefficient());
+    }
+}
+
+TEST(Polynomial, automatic_multiplication_keeps_small_terms_next_to_large_ones)
+{
+    using Strategy = Polynomial::MultiplicationStrategy;
+
+    Polynomial p("1000000");
+    for (int i = 0; i < 30; i++) {
+        for (int j = 0; j < 30; j++) {
+            if (i || j) {
+                p.insert(Monomial(0.25, i, j, 0));
+            }
+        }
+    }
+
+    EXPECT_EQ(p.multiply(p, Strategy::Heap), p * p);
+
+    // the forced transform is not exact, but it still should tell such terms from the round-off
+    p -= Polynomial("999000");
+    EXPECT_EQ(p.multiply(p, Strategy::Heap).size(), p.multiply(p, Strategy::Kronecker).size());
+}
+
+TEST(Polynomial, kronecker_multiplication_checks_negative_degrees_overflow)
+{
+    using Strategy = Polynomial::MultiplicationStrategy;
+
+    Polynomial p1("x + 1"), p2("x + 1");
+    p1.insert(Monomial("x^-3"));
+    p2.insert(Monomial("x^-126"));
+
+    EXPECT_ANY_THROW(Polynomial res = p1.multiply(p2, Strategy::Heap));
+    EXPECT_ANY_THROW(Polynomial res = p1.multiply(p2, Strategy::Kronecker));
+}
+
+TEST(Polynomial, parallel_multiplication_matches_serial)
+{
+    Polynomial p1, p2;
+    for (int i = 0; i < 20; i++) {
+        for (int j = 0; j < 20; j++) {
+            p1.insert(Monomial(i - j, i, j, (i * j) % 5));
+            p2.insert(Monomial(i + j + 1, j, (i + j) % 7, i));
+        }
+    }
+
+    const size_t threads = Polynomial::mult_threads();
+
+    Polynomial::set_mult_threads(1);
+    const Polynomial expected = p1 * p2;
+    Polynomial::set_mult_threads(4);
+    const Polynomial res = p1 * p2;
+    Polynomial::set_mult_threads(threads);
+
+    EXPECT_EQ(expected, res);
+}
+
+TEST(Polynomial, can_multiply_polynomials_with_negative_degrees)
+{
+    Polynomial p1, p2, expected;
+    p1.insert(Monomial(1, -1, 0, 0));
+    p1.insert(Monomial(1));
+    p2.insert(Monomial(1, 1, 0, 0));
+    p2.insert(Monomial(1));
+    expected.insert(Monomial(1, -1, 0, 0));
+    expected.insert(Monomial(1, 1, 0, 0));
+    expected.insert(Monomial(2));
+
+    EXPECT_EQ(expected, p1 * p2);
+}
+
+TEST(Polynomial, square_matches_product)
+{
+    Polynomial sparse("3x^4y^2 - 2x^3z + 7xy^5z^2 + 4y - 1"), dense, negative;
+    for (int i = 0; i < 12; i++) {
+        for (int j = 0; j < 12; j++) {
+            dense.insert(Monomial(i - j, i, j, (i + j) % 3));
+            negative.insert(Monomial(i + j + 1, i - 6, j, -(i * j % 4)));
+        }
+    }
+
+    EXPECT_EQ(sparse * sparse, sparse.square());
+    EXPECT_EQ(dense * dense, dense.square());
+    EXPECT_EQ(negative * negative, negative.square());
+    EXPECT_EQ(0u, Polynomial().square().size());
+}
+
+TEST(Polynomial, can_raise_to_power)
+{
+    const Polynomial p("x - 2y + 3z - 4");
+    Polynomial expected("1");
+    for (unsigned e = 0; e <= 9; e++) {
+        EXPECT_EQ(expected, p.pow(e));
+        expected *= p;
+    }
+
+    EXPECT_EQ(Polynomial("-8x^6y^3z^9"), Polynomial("-2x^2yz^3").pow(3));
+    EXPECT_EQ(Polynomial("x^4 - 4x^3y + 6x^2y^2 - 4xy^3 + y^4"), Polynomial("x - y").pow(4));
+    EXPECT_EQ(0u, Polynomial().pow(5).size());
+    EXPECT_ANY_THROW(static_cast<void>(Polynomial("x^100").pow(2)));
+}
+
+TEST(Polynomial, binomial_power_checks_degree_overflow_first)
+{
+    const Polynomial p("x + 1");
+
+    EXPECT_EQ(Polynomial("x^127"), Polynomial("x").pow(127));
+    EXPECT_NO_THROW(static_cast<void>(p.pow(127)));
+    EXPECT_THROW(static_cast<void>(p.pow(128)), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(p.pow(4000000000u)), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(p.pow(std::numeric_limits<unsigned>::max())), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(Polynomial("y - x^2").pow(64)), std::runtime_error);
+}
+
+TEST(Polynomial, can_substitute_variable)
+{
+    const Polynomial p("x^3 - 2x^2y + xz - 5");
+
+    EXPECT_EQ(Polynomial("x^3 + 3x^2 + 3x - 2x^2y - 4xy - 2y + xz + z - 4"), p.substitute('x', Polynomial("x + 1")));
+    EXPECT_EQ(Polynomial("x^3y^3 - 2x^2y^3 + xyz - 5"), p.substitute('x', Polynomial("xy")));
+    EXPECT_EQ(Polynomial("-5"), p.substitute('x', Polynomial()));
+    EXPECT_EQ(p, p.substitute('y', Polynomial("y")));
+}
+
+TEST(Polynomial, substitutes_all_variables_at_once)
+{
+    const Polynomial p("3x^4y^2 - 2x^3z + 7xy^5z^2 + 4y - 1");
+    const Polynomial::Substitution swap = { { 'x', Polynomial("y") }, { 'y', Polynomial("x") } };
+    const Polynomial::Substitution shift = {
+        { 'x', Polynomial("x + y") }, { 'y', Polynomial("2y - z") }, { 'z', Polynomial("z + 3") }
+    };
+
+    EXPECT_EQ(Polynomial("3x^2y^4 - 2y^3z + 7x^5yz^2 + 4x - 1"), p.substitute(swap));
+
+    const Polynomial res = p.substitute(shift);
+    for (double x = -1.5; x <= 1.5; x += 0.75) {
+        const Monomial::Point point = { { 'x', x }, { 'y', 2 - x }, { 'z', x / 2 } };
+        const Monomial::Point shifted = { { 'x', x + 2 - x }, { 'y', 2 * (2 - x) - x / 2 }, { 'z', x / 2 + 3 } };
+        EXPECT_NEAR(p.calculate(shifted), res.calculate(point), 1e-9 * std::abs(p.calculate(shifted)) + 1e-9);
+    }
+}
+
+TEST(Polynomial, substitutes_negative_degrees_by_single_terms)
+{
+    Polynomial p, expected;
+    p.insert(Monomial(1, -2, 0, 0));
+    p.insert(Monomial(1, 1, 0, 0));
+    expected.insert(Monomial(0.25, -2, -2, 0));
+    expected.insert(Monomial(2, 1, 1, 0));
+
+    EXPECT_EQ(expected, p.substitute('x', Polynomial("2xy")));
+    EXPECT_ANY_THROW(static_cast<void>(p.substitute('x', Polynomial("x + 1"))));
+    EXPECT_ANY_THROW(static_cast<void>(p.substitute('a', Polynomial("x"))));
+}
+
+TEST(Polynomial, can_divide_by_polynomial)
+{
+    const Polynomial p("x^2 - y^2");
+
+    EXPECT_EQ(Polynomial("x + y"), p / Polynomial("x - y"));
+    EXPECT_EQ(Polynomial("x^3 - xy^2"), p * Polynomial("x^2") / Polynomial("x"));
+}
+
+TEST(Polynomial, division_drops_the_remainder_whatever_the_divisor_size)
+{
+    // x + y = 1 * x + y, x^2 + y = 1 * (x^2 - 1) + (y + 1)
+    EXPECT_EQ(Polynomial("1"), Polynomial("x + y") / Polynomial("x"));
+    EXPECT_EQ(Polynomial("1"), Polynomial("x^2 + y") / Polynomial("x^2 - 1"));
+    EXPECT_EQ(0, (Polynomial("y") / Polynomial("x")).size());
+}
+
+TEST(Polynomial, can_divide_by_term)
+{
+    Polynomial expected("1");
+    expected.insert(Monomial("x^-1y"));
+
+    EXPECT_EQ(expected, Polynomial("x + y").divide_by_term(Monomial("x")));
+    EXPECT_EQ(Polynomial("2x + 1"), Polynomial("4x^2y + 2xy").divide_by_term(Monomial("2xy")));
+}
+
+TEST(Polynomial, can_divide_with_remainder)
+{
+    const Polynomial f("x^2y + xy^2 + y^2"), g1("xy - 1"), g2("y^2 - 1");
+
+    const auto res = f.divmod({ g1, g2 });
+
+    // the textbook example, reduced by xy - 1 first
+    EXPECT_EQ(Polynomial("x + y"), res.quotients[0]);
+    EXPECT_EQ(Polynomial("1"), res.quotients[1]);
+    EXPECT_EQ(Polynomial("x + y + 1"), res.remainder);
+    EXPECT_EQ(f, res.quotients[0] * g1 + res.quotients[1] * g2 + res.remainder);
+}
+
+TEST(Polynomial, can_check_exact_division)
+{
+    typedef BasicPolynomial<BasicMonomial<3, char, MonomialOrder::GradedReverseLex, BigRational>> RationalPolynomial;
+
+    const RationalPolynomial a("1/2x^3 - 2xyz + 3/7"), b("x + y^2 - z + 1");
+    const auto [quotient, remainder] = (a * b).divmod(b);
+
+    EXPECT_EQ(a, quotient);
+    EXPECT_EQ(0, remainder.size());
+    EXPECT_TRUE((a * b).is_divisible_by(a));
+    EXPECT_FALSE(RationalPolynomial(a * b + RationalPolynomial("x")).is_divisible_by(a));
+}
+
+TEST(Polynomial, division_requires_non_negative_degrees)
+{
+    Polynomial p("x + 1");
+    p.insert(Monomial(1, -1, 0, 0));
+
+    EXPECT_THROW(static_cast<void>(p.divmod(Polynomial("x + 1"))), std::invalid_argument);
+    EXPECT_THROW(static_cast<void>(Polynomial("x").divmod(Polynomial())), std::domain_error);
+}
+
 TEST(Polynomial, can_differentiate)
 {
     const Polynomial m("10x^3y^4z^5 + x^2");
@@ -67,6 +518,34 @@ TEST(Polynomial, can_differentiate)
     EXPECT_EQ(Polynomial("30x^2y^4z^5 + 2x"), derivativeX);
 }
 
+TEST(Polynomial, gradient_matches_partial_derivatives)
+{
+    const Polynomial p("3x^4y^2 - 2x^3z + 7xy^5z^2 + 4y - 1");
+    const Polynomial::Gradient g = p.gradient();
+
+    EXPECT_EQ(Polynomial("12x^3y^2 - 6x^2z + 7y^5z^2"), g[0]);
+    EXPECT_EQ(Polynomial("6x^4y + 35xy^4z^2 + 4"), g[1]);
+    EXPECT_EQ(Polynomial("-2x^3 + 14xy^5z"), g[2]);
+
+    const std::vector<Polynomial::Gradient> jacobian = Polynomial::jacobian({ p, Polynomial("xyz") });
+    ASSERT_EQ(2u, jacobian.size());
+    EXPECT_EQ(g, jacobian[0]);
+    EXPECT_EQ(Polynomial("xy"), jacobian[1][2]);
+}
+
+TEST(Polynomial, hessian_is_symmetric)
+{
+    Polynomial p("x^3y^2 + 5yz^2 - 2xz");
+    p.insert(Monomial(2, -1, 2, 0));
+    const Polynomial::Hessian h = p.hessian();
+
+    for (char u = 'x'; u <= 'z'; u++) {
+        for (char v = 'x'; v <= 'z'; v++) {
+            EXPECT_EQ(p.differentiate(u).differentiate(v), h[u - 'x'][v - 'x']);
+        }
+    }
+}
+
 TEST(Polynomial, can_integrate)
 {
     const Polynomial m("12x^3y^4z^5 + 3x^2");
@@ -74,3 +553,73 @@ TEST(Polynomial, can_integrate)
 
     EXPECT_EQ(Polynomial("3x^4y^4z^5 + x^3"), antiderivativeX);
 }
+
+TEST(Polynomial, rational_coefficients_stay_exact)
+{
+    typedef BasicPolynomial<BasicMonomial<3, char, MonomialOrder::Lex, BigRational>> RationalPolynomial;
+
+    const RationalPolynomial p("1/3x + 1/7y - 0.1");
+    RationalPolynomial power("1");
+    for (int i = 0; i < 10; i++) {
+        power *= p;
+    }
+
+    // 1/3 and 0.1 have no exact double, yet x^10 and the constant term come out exact
+    EXPECT_EQ(BigRational(1, 59049), power[0].coefficient());
+    EXPECT_EQ(BigRational("1/10000000000"), power[power.size() - 1].coefficient());
+    EXPECT_EQ(RationalPolynomial("1/3x^2 - 1/10x"), RationalPolynomial("1/3x - 0.1") * RationalPolynomial("x"));
+    EXPECT_EQ(RationalPolynomial("1/12x^4"), RationalPolynomial("1/3x^3").integrate('x'));
+}
+
+TEST(Polynomial, multiplication_strategies_agree_for_rational_coefficients)
+{
+    typedef BasicPolynomial<BasicMonomial<3, char, MonomialOrder::Lex, BigRational>> RationalPolynomial;
+    typedef PolynomialBase::MultiplicationStrategy Strategy;
+
+    RationalPolynomial p("1");
+    const RationalPolynomial factor("1/2x + 1/3y + 1/5z + 1/7");
+    for (int i = 0; i < 6; i++) {
+        p *= factor;
+    }
+
+    const RationalPolynomial heap = p.multiply(p, Strategy::Heap);
+
+    EXPECT_EQ(heap, p.multiply(p, Strategy::Hash));
+    // no transforms for exact coefficients, falls back to the hash table
+    EXPECT_EQ(heap, p.multiply(p, Strategy::Kronecker));
+}
+
+TEST(Polynomial, can_use_modular_coefficients)
+{
+    typedef BasicPolynomial<BasicMonomial<3, char, MonomialOrder::Lex, MontgomeryInt<7>>> PolynomialMod7;
+
+    const PolynomialMod7 p("x + 1");
+    PolynomialMod7 power("1");
+    for (int i = 0; i < 7; i++) {
+        power *= p;
+    }
+
+    // binomial coefficients of the prime power vanish modulo the prime
+    EXPECT_EQ(PolynomialMod7("x^7 + 1"), power);
+    EXPECT_EQ(PolynomialMod7("4x"), PolynomialMod7("1/2x"));
+    EXPECT_EQ(power, p.pow(7));
+}
+
+TEST(Polynomial, modular_product_matches_integral_one)
+{
+    typedef BasicPolynomial<BasicMonomial<3, char, MonomialOrder::Lex, Mod63>> PolynomialMod;
+
+    const Polynomial p("x - 2y + 3z - 4");
+    const PolynomialMod pMod("x - 2y + 3z - 4");
+    Polynomial power("1");
+    PolynomialMod powerMod("1");
+    for (int i = 0; i < 8; i++) {
+        power *= p;
+        powerMod *= pMod;
+    }
+
+    ASSERT_EQ(power.size(), powerMod.size());
+    for (size_t i = 0; i < power.size(); i++) {
+        EXPECT_EQ(power[i].coefficient(), powerMod[i].coefficient().to_signed());
+    }
+}
@@ -0,0 +1,85 @@
+#include <gtest.h>
+#include "rational.h"
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+TEST(BigInteger, can_convert_to_and_from_decimal)
+{
+    const std::string raw = "-123456789012345678901234567890";
+
+    EXPECT_EQ(raw, BigInteger(raw).to_string());
+    EXPECT_EQ("0", BigInteger("-0").to_string());
+    EXPECT_ANY_THROW(BigInteger("12a"));
+}
+
+TEST(BigInteger, divmod_truncates_like_built_in_division)
+{
+    const BigInteger a("-1000000000000000000000000000007"), b("123456789123");
+    BigInteger q, r;
+
+    BigInteger::divmod(a, b, q, r);
+
+    EXPECT_EQ(a, q * b + r);
+    EXPECT_TRUE(r.is_negative());
+    EXPECT_TRUE(r.abs() < b);
+}
+
+TEST(BigRational, keeps_lowest_terms)
+{
+    const BigRational r(6, -4);
+
+    EXPECT_EQ("-3/2", r.to_string());
+    EXPECT_EQ(BigRational(-3, 2), r);
+}
+
+TEST(BigRational, can_parse_fractions_and_decimals)
+{
+    EXPECT_EQ(BigRational(-1, 8), BigRational("-0.125"));
+    EXPECT_EQ(BigRational(1, 2), BigRational("3/6"));
+    EXPECT_EQ(BigRational(5, 4), BigRational("2.5/2"));
+    EXPECT_ANY_THROW(BigRational("1/0"));
+    EXPECT_ANY_THROW(BigRational("."));
+}
+
+TEST(BigRational, falls_back_to_heap_on_overflow_and_back)
+{
+    const BigRational max(std::numeric_limits<int64_t>::max());
+
+    const BigRational sum = max + 1;
+    const BigRational back = sum - 1;
+
+    EXPECT_TRUE(max.is_inline());
+    EXPECT_FALSE(sum.is_inline());
+    EXPECT_EQ("9223372036854775808", sum.to_string());
+    EXPECT_TRUE(back.is_inline());
+    EXPECT_EQ(max, back);
+}
+
+TEST(BigRational, is_exact_through_long_computations)
+{
+    BigRational sum;
+    for (int i = 1; i <= 60; i++) {
+        sum += BigRational(1, i);
+    }
+    for (int i = 60; i >= 1; i--) {
+        sum -= BigRational(1, i);
+    }
+
+    EXPECT_TRUE(sum.is_zero());
+    EXPECT_TRUE(sum.is_inline());
+}
+
+TEST(BigRational, compares_big_values)
+{
+    const BigRational a("100000000000000000000/3"), b("100000000000000000001/3");
+
+    EXPECT_TRUE(a < b);
+    EXPECT_TRUE(-b < -a);
+    EXPECT_TRUE(BigRational(1) < a);
+}
+
+TEST(BigRational, throws_when_dividing_by_zero)
+{
+    EXPECT_THROW(BigRational(1) / BigRational(0), std::domain_error);
+}